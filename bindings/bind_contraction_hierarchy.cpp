@@ -0,0 +1,16 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/eigen.h>
+#include "contraction_hierarchy.hpp"
+
+
+namespace py = pybind11;
+
+void init_contraction_hierarchy(py::module_ &m)
+{
+    py::class_<ContractionHierarchy>(m, "ContractionHierarchy")
+        .def(py::init<const Roadmap&>())
+        .def_property_readonly("n_states", &ContractionHierarchy::get_n_states)
+        .def_property_readonly("n_shortcuts", &ContractionHierarchy::get_n_shortcuts)
+        .def("query", py::overload_cast<const Eigen::VectorXd&, const Eigen::VectorXd&>(&ContractionHierarchy::query, py::const_))
+        .def("query", py::overload_cast<const Eigen::VectorXd&, const Eigen::VectorXd&, SearchStatistics&>(&ContractionHierarchy::query, py::const_));
+}
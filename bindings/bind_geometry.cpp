@@ -1,7 +1,10 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 #include <pybind11/eigen.h>
 #include <pybind11/operators.h>
 #include "geometry.hpp"
+#include "mesh_geometry.hpp"
+#include "polygon_index.hpp"
 
 
 namespace py = pybind11;
@@ -15,9 +18,24 @@ void init_geometry(py::module_ &m)
         .def_property_readonly("orientation", &Polygon::orientation)
         .def_property_readonly("is_solid", &Polygon::is_solid)
         .def_property_readonly("is_hollow", &Polygon::is_hollow)
+        .def_property_readonly("is_convex", &Polygon::is_convex)
         .def("__getitem__", [](const Polygon& polygon, int i) {return polygon[i];});
 
     m.def("inside_polygon", &inside_polygon);
     m.def("segments_intersect", &segments_intersect);
     m.def("segment_intersects_polygon", &segment_intersects_polygon);
+    m.def("distance_to_boundary", &distance_to_boundary);
+
+    m.def("inside_polygons", &inside_polygons, py::arg("points"), py::arg("polygons"), py::arg("n_threads") = 0,
+        py::call_guard<py::gil_scoped_release>());
+    m.def("segments_intersect_polygons", &segments_intersect_polygons, py::arg("segments"), py::arg("polygons"),
+        py::arg("n_threads") = 0, py::call_guard<py::gil_scoped_release>());
+
+    py::class_<TriangleMesh>(m, "TriangleMesh")
+        .def(py::init<Eigen::MatrixX3d, Eigen::MatrixX3i>(), py::arg("vertices"), py::arg("faces"))
+        .def_property_readonly("vertices", &TriangleMesh::vertices)
+        .def_property_readonly("faces", &TriangleMesh::faces)
+        .def_property_readonly("n_faces", &TriangleMesh::n_faces);
+
+    py::register_exception<BadMeshException>(m, "BadMeshException");
 }
\ No newline at end of file
@@ -0,0 +1,17 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/eigen.h>
+#include "incremental_planner.hpp"
+
+
+namespace py = pybind11;
+
+void init_incremental_planner(py::module_ &m)
+{
+    py::class_<IncrementalPlanner>(m, "IncrementalPlanner")
+        .def(py::init<const Roadmap&, const Eigen::VectorXd&, const Eigen::VectorXd&>())
+        .def("set_edge_cost", &IncrementalPlanner::set_edge_cost)
+        .def("edge_cost", &IncrementalPlanner::edge_cost)
+        .def("plan", py::overload_cast<>(&IncrementalPlanner::plan))
+        .def("plan", py::overload_cast<SearchStatistics&>(&IncrementalPlanner::plan))
+        .def_property_readonly("path_cost", &IncrementalPlanner::get_path_cost);
+}
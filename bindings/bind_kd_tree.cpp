@@ -1,4 +1,5 @@
 #include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
 #include <pybind11/eigen.h>
 #include "kd_tree.hpp"
 #include "exceptions.hpp"
@@ -13,9 +14,12 @@ void init_kd_tree(py::module_ &m)
         .def("append_state", &kdTree::append_state)
         .def("nearest_neighbor", &kdTree::nearest_neighbor)
         .def("k_nearest_neighbors", &kdTree::k_nearest_neighbors)
+        .def("radius_search", &kdTree::radius_search)
+        .def("states_within", &kdTree::states_within)
         .def("count_states", &kdTree::count_states)
         .def("at_depth", &kdTree::at_depth);
     
     py::register_exception<BadStateSizeException>(m, "BadStateSizeException");
+    py::register_exception<BadParameterException>(m, "BadParameterException");
     py::register_exception<EmptyTreeException>(m, "EmptyTreeException");
 }
\ No newline at end of file
@@ -0,0 +1,27 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/eigen.h>
+#include "resumable_search.hpp"
+
+
+namespace py = pybind11;
+
+void init_resumable_search(py::module_ &m)
+{
+    py::enum_<SearchStatus>(m, "SearchStatus")
+        .value("in_progress", SearchStatus::in_progress)
+        .value("found", SearchStatus::found)
+        .value("failed", SearchStatus::failed);
+
+    py::class_<ResumableSearch>(m, "ResumableSearch")
+        .def(py::init<const Roadmap&, const Eigen::VectorXd&, const Eigen::VectorXd&, bool>(),
+            py::arg("roadmap"), py::arg("start_state"), py::arg("goal_state"), py::arg("use_landmarks") = true,
+            py::keep_alive<1, 2>())
+        .def("step", &ResumableSearch::step, py::arg("max_expansions"))
+        .def("step_for", &ResumableSearch::step_for, py::arg("microseconds"))
+        .def("path", &ResumableSearch::path)
+        .def("best_partial_path", &ResumableSearch::best_partial_path)
+        .def_property_readonly("status", &ResumableSearch::get_status)
+        .def_property_readonly("n_expansions", &ResumableSearch::get_n_expansions);
+
+    py::register_exception<RoadmapChangedException>(m, "RoadmapChangedException");
+}
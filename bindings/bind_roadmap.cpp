@@ -1,7 +1,9 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
+#include <algorithm>
 #include "roadmap.hpp"
+#include "search_roadmap.hpp"
 #include "search_space.hpp"
 #include "probabilistic_roadmap.hpp"
 
@@ -9,11 +11,17 @@ namespace py = pybind11;
 
 void init_roadmap(py::module_& m)
 {
+    py::enum_<EdgeValidity>(m, "EdgeValidity")
+        .value("unknown", EdgeValidity::unknown)
+        .value("valid", EdgeValidity::valid)
+        .value("invalid", EdgeValidity::invalid);
+
     py::class_<RoadmapNode>(m, "RoadmapNode")
         .def(py::init<>())
         .def_property_readonly("state", &RoadmapNode::get_state)
         .def_property_readonly("neighbors", &RoadmapNode::get_neighbors)
-        .def_property_readonly("costs", &RoadmapNode::get_costs);
+        .def_property_readonly("costs", &RoadmapNode::get_costs)
+        .def_property_readonly("validity", &RoadmapNode::get_validity);
 
     py::class_<Roadmap>(m, "Roadmap")
         .def(py::init<int>())
@@ -21,16 +29,148 @@ void init_roadmap(py::module_& m)
         .def_property_readonly("n_states", &Roadmap::get_n_states)
         .def_property_readonly("nodes", &Roadmap::get_nodes)
         .def_property_readonly("states", &Roadmap::get_states)
-        .def("add_node", &Roadmap::add_node)
+        .def("add_node", &Roadmap::add_node,
+            py::arg("state"), py::arg("neighbor_states"), py::arg("neighbor_costs"), py::arg("validity") = EdgeValidity::valid)
+        .def("set_edge_validity", &Roadmap::set_edge_validity)
+        .def("edge_validity", &Roadmap::edge_validity)
         .def("node_at", &Roadmap::node_at)
         .def("node_nearest", &Roadmap::node_nearest)
         .def("k_nodes_nearest", &Roadmap::k_nodes_nearest)
         .def("state_nearest", &Roadmap::state_nearest)
-        .def("k_states_nearest", &Roadmap::k_states_nearest);
+        .def("k_states_nearest", &Roadmap::k_states_nearest)
+        .def("states_within", &Roadmap::states_within)
+        .def("preprocess_landmarks", &Roadmap::preprocess_landmarks)
+        .def_property_readonly("n_landmarks", &Roadmap::get_n_landmarks)
+        .def_property_readonly("landmarks", &Roadmap::get_landmarks)
+        .def_property_readonly("landmark_distances", &Roadmap::get_landmark_distances)
+        .def_property_readonly("component_labels", &Roadmap::get_component_labels)
+        .def("count_components", &Roadmap::count_components)
+        .def(py::pickle(
+            [](const Roadmap& roadmap) {
+                std::vector<Eigen::MatrixXd> neighbors;
+                std::vector<Eigen::VectorXd> costs;
+                std::vector<std::vector<EdgeValidity>> validity;
+                for (const RoadmapNode& node : roadmap.get_nodes()) {
+                    neighbors.push_back(node.get_neighbors());
+                    costs.push_back(node.get_costs());
+                    validity.push_back(node.get_validity());
+                }
+
+                return py::make_tuple(roadmap.get_state_size(), roadmap.get_states(), neighbors, costs,
+                    roadmap.get_landmarks(), roadmap.get_landmark_distances(), validity);
+            },
+            [](py::tuple t) {
+                Roadmap roadmap(t[0].cast<int>());
+
+                Eigen::MatrixXd states = t[1].cast<Eigen::MatrixXd>();
+                std::vector<Eigen::MatrixXd> neighbors = t[2].cast<std::vector<Eigen::MatrixXd>>();
+                std::vector<Eigen::VectorXd> costs = t[3].cast<std::vector<Eigen::VectorXd>>();
+                std::vector<std::vector<EdgeValidity>> validity = t[6].cast<std::vector<std::vector<EdgeValidity>>>();
+
+                // States are stored in the roadmap's order, so each edge is restored once by adding it
+                // with the node that comes later in that order
+                for (int i = 0; i < states.rows(); i++) {
+                    Eigen::VectorXd state = states.row(i);
+
+                    std::vector<int> earlier;
+                    for (int j = 0; j < neighbors[i].rows(); j++) {
+                        const Eigen::VectorXd neighbor = neighbors[i].row(j);
+                        if (std::lexicographical_compare(neighbor.data(), neighbor.data() + neighbor.size(), state.data(), state.data() + state.size()))
+                            earlier.push_back(j);
+                    }
+
+                    Eigen::MatrixXd node_neighbors(earlier.size(), states.cols());
+                    Eigen::VectorXd node_costs(earlier.size());
+                    for (int j = 0; j < (int)earlier.size(); j++) {
+                        node_neighbors.row(j) = neighbors[i].row(earlier[j]);
+                        node_costs(j) = costs[i](earlier[j]);
+                    }
+
+                    roadmap.add_node(state, node_neighbors, node_costs);
+                }
+
+                // Edges were restored as valid, so mark the rest afterwards
+                for (int i = 0; i < states.rows(); i++) {
+                    for (int j = 0; j < neighbors[i].rows(); j++) {
+                        if (validity[i][j] != EdgeValidity::valid)
+                            roadmap.set_edge_validity(states.row(i), neighbors[i].row(j), validity[i][j]);
+                    }
+                }
+
+                Eigen::MatrixXd landmarks = t[4].cast<Eigen::MatrixXd>();
+                if (landmarks.rows())
+                    roadmap.set_landmarks(landmarks, t[5].cast<Eigen::MatrixXd>());
+
+                return roadmap;
+            }));
+
+    py::class_<SearchStatistics>(m, "SearchStatistics")
+        .def(py::init<>())
+        .def_readonly("n_expansions", &SearchStatistics::n_expansions)
+        .def_readonly("n_edge_checks", &SearchStatistics::n_edge_checks);
+
+    py::enum_<ConnectionStrategy>(m, "ConnectionStrategy")
+        .value("k_nearest", ConnectionStrategy::k_nearest)
+        .value("k_nearest_star", ConnectionStrategy::k_nearest_star)
+        .value("radius_star", ConnectionStrategy::radius_star);
+
+    py::class_<SamplingMix>(m, "SamplingMix")
+        .def(py::init([](double gaussian_ratio, double bridge_ratio, double sigma) {
+                return SamplingMix{gaussian_ratio, bridge_ratio, sigma};
+            }),
+            py::arg("gaussian_ratio") = 0., py::arg("bridge_ratio") = 0., py::arg("sigma") = 1.)
+        .def_readwrite("gaussian_ratio", &SamplingMix::gaussian_ratio)
+        .def_readwrite("bridge_ratio", &SamplingMix::bridge_ratio)
+        .def_readwrite("sigma", &SamplingMix::sigma);
+
+    m.def("build_prm", &build_prm,
+        py::arg("n_samples"), py::arg("n_batch"), py::arg("k_neighbors"), py::arg("search_space"), py::arg("n_threads") = 1,
+        py::arg("strategy") = ConnectionStrategy::k_nearest, py::arg("gamma") = 0., py::arg("lazy") = false, py::arg("seed") = -1,
+        py::arg("mix") = SamplingMix{}, py::call_guard<py::gil_scoped_release>());
+
+    m.def("extend_prm", [](Roadmap& roadmap, int n_additional, int n_batch, int k_neighbors, const SearchSpace& search_space,
+            int n_threads, ConnectionStrategy strategy, double gamma, bool lazy, const Eigen::VectorXd& region_min,
+            const Eigen::VectorXd& region_max, int oversampling) {
+            // The roadmap belongs to Python, so it is only read and changed with the GIL held, which
+            // keeps other Python threads off it; the sampling and collision checks run without it
+            extend_prm(roadmap, n_additional, n_batch, k_neighbors, search_space, n_threads, strategy, gamma, lazy,
+                region_min, region_max, oversampling, [](const std::function<void()>& work) {
+                    py::gil_scoped_release release;
+                    work();
+                });
+        },
+        py::arg("roadmap"), py::arg("n_additional"), py::arg("n_batch"), py::arg("k_neighbors"), py::arg("search_space"),
+        py::arg("n_threads") = 1, py::arg("strategy") = ConnectionStrategy::k_nearest, py::arg("gamma") = 0., py::arg("lazy") = false,
+        py::arg("region_min") = Eigen::VectorXd(), py::arg("region_max") = Eigen::VectorXd(), py::arg("oversampling") = 1);
+
+    m.def("build_sparse_roadmap", &build_sparse_roadmap,
+        py::arg("search_space"), py::arg("visibility_radius"), py::arg("stretch"), py::arg("max_failures") = 1000,
+        py::arg("max_samples") = 100000, py::arg("seed") = -1, py::call_guard<py::gil_scoped_release>());
+
+    m.def("prm_star_gamma", &prm_star_gamma);
+
+    m.def("dijkstra", py::overload_cast<const Roadmap&, const Eigen::VectorXd&, const Eigen::VectorXd&>(&dijkstra));
+    m.def("dijkstra", py::overload_cast<const Roadmap&, const Eigen::VectorXd&, const Eigen::VectorXd&, SearchStatistics&>(&dijkstra));
+
+    m.def("alt_search", py::overload_cast<const Roadmap&, const Eigen::VectorXd&, const Eigen::VectorXd&>(&alt_search));
+    m.def("alt_search", py::overload_cast<const Roadmap&, const Eigen::VectorXd&, const Eigen::VectorXd&, SearchStatistics&>(&alt_search));
+
+    m.def("lazy_search", py::overload_cast<Roadmap&, const SearchSpace&, const Eigen::VectorXd&, const Eigen::VectorXd&>(&lazy_search));
+    m.def("lazy_search", py::overload_cast<Roadmap&, const SearchSpace&, const Eigen::VectorXd&, const Eigen::VectorXd&, SearchStatistics&>(&lazy_search));
+
+    m.def("dijkstra_costs", &dijkstra_costs);
 
-    m.def("build_prm", &build_prm);
+    m.def("delta_stepping", [](const Roadmap& roadmap, const Eigen::VectorXd& source_state, int n_threads, double delta) {
+            // The roadmap's cached graph is rebuilt on demand, so do that while other threads are held off
+            roadmap.get_graph();
 
-    m.def("dijkstra", &dijkstra);
+            py::gil_scoped_release release;
+            return delta_stepping(roadmap, source_state, n_threads, delta);
+        },
+        py::arg("roadmap"), py::arg("source_state"), py::arg("n_threads") = 0, py::arg("delta") = 0.);
 
     py::register_exception<MissingStateRoadmapException>(m, "MissingStateRoadmapException");
+    py::register_exception<MissingEdgeRoadmapException>(m, "MissingEdgeRoadmapException");
+    py::register_exception<BadLandmarksException>(m, "BadLandmarksException");
+    py::register_exception<EmptyRegionException>(m, "EmptyRegionException");
 }
\ No newline at end of file
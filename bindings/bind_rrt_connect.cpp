@@ -0,0 +1,18 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/eigen.h>
+#include "rrt_connect.hpp"
+
+
+namespace py = pybind11;
+
+void init_rrt_connect(py::module_ &m)
+{
+    m.def("rrt_connect", py::overload_cast<const SearchSpace&, const Eigen::VectorXd&, const Eigen::VectorXd&, double, double, int, double, long>(&rrt_connect),
+        py::arg("search_space"), py::arg("start_state"), py::arg("goal_state"), py::arg("step_size"), py::arg("goal_bias") = 0.05,
+        py::arg("max_iterations") = 10000, py::arg("max_seconds") = 0., py::arg("seed") = -1,
+        py::call_guard<py::gil_scoped_release>());
+    m.def("rrt_connect", py::overload_cast<const SearchSpace&, const Eigen::VectorXd&, const Eigen::VectorXd&, double, double, int, double, long, SearchStatistics&>(&rrt_connect),
+        py::arg("search_space"), py::arg("start_state"), py::arg("goal_state"), py::arg("step_size"), py::arg("goal_bias"),
+        py::arg("max_iterations"), py::arg("max_seconds"), py::arg("seed"), py::arg("statistics"),
+        py::call_guard<py::gil_scoped_release>());
+}
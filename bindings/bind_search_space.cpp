@@ -1,8 +1,14 @@
+#include <array>
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
 #include <pybind11/operators.h>
+#include "box_space.hpp"
+#include "grid_space.hpp"
+#include "mesh_space.hpp"
+#include "sampling.hpp"
 #include "search_space.hpp"
+#include "se2_polygon_space.hpp"
 
 
 namespace py = pybind11;
@@ -22,6 +28,16 @@ public:
         );
     }
 
+    // Trampoline valid_state, which throws NoStateCheckException unless overridden
+    bool valid_state(const Eigen::VectorXd& state) const override {
+        PYBIND11_OVERRIDE(
+            bool,               // Return type
+            SearchSpace,        // Parent class
+            valid_state,        // Name of function in C++
+            state               // Argument(s)
+        );
+    }
+
     // Trampoline valid_transition
     bool valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const override {
         PYBIND11_OVERRIDE_PURE(
@@ -36,23 +52,153 @@ public:
     // Trampoline transition_cost
     double transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const override {
         PYBIND11_OVERRIDE_PURE(
-            bool,               // Return type
+            double,             // Return type
             SearchSpace,        // Parent class
             transition_cost,    // Name of function in C++
             a,                  // Argument(s)
             b
         );
     }
+
+    // Trampoline interpolate, which steps along a straight line unless overridden
+    Eigen::VectorXd interpolate(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double t) const override {
+        PYBIND11_OVERRIDE(
+            Eigen::VectorXd,    // Return type
+            SearchSpace,        // Parent class
+            interpolate,        // Name of function in C++
+            a,                  // Argument(s)
+            b,
+            t
+        );
+    }
+
+    // Trampoline sampling_volume, which is 0 unless overridden
+    double sampling_volume() const override {
+        PYBIND11_OVERRIDE(
+            double,             // Return type
+            SearchSpace,        // Parent class
+            sampling_volume     // Name of function in C++
+        );
+    }
+
+    // Trampoline valid_transitions, which falls back to looping over valid_transition
+    VectorXb valid_transitions(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b) const override {
+        PYBIND11_OVERRIDE(
+            VectorXb,           // Return type
+            SearchSpace,        // Parent class
+            valid_transitions,  // Name of function in C++
+            a,                  // Argument(s)
+            b
+        );
+    }
+
+    // Trampoline transition_costs, which falls back to looping over transition_cost
+    Eigen::VectorXd transition_costs(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b) const override {
+        PYBIND11_OVERRIDE(
+            Eigen::VectorXd,    // Return type
+            SearchSpace,        // Parent class
+            transition_costs,   // Name of function in C++
+            a,                  // Argument(s)
+            b
+        );
+    }
 };
 
 void init_search_space(py::module_ &m)
 {
+    py::class_<RandomStream>(m, "RandomStream")
+        .def(py::init<uint64_t, uint64_t>(), py::arg("seed") = 0, py::arg("stream") = 0)
+        .def_property_readonly("seed", &RandomStream::get_seed)
+        .def_property_readonly("stream", &RandomStream::get_stream)
+        .def("substream", &RandomStream::substream)
+        .def("uniform", py::overload_cast<>(&RandomStream::uniform))
+        .def("uniform", py::overload_cast<double, double>(&RandomStream::uniform))
+        .def("uniform_block", &RandomStream::uniform_block);
+
+    m.def("philox4x32_10", [](std::array<uint32_t, 4> counter, std::array<uint32_t, 2> key) {
+        philox4x32_10(counter.data(), key[0] | (uint64_t)key[1] << 32);
+        return counter;
+    }, py::arg("counter"), py::arg("key"));
+
+    py::class_<HaltonSequence>(m, "HaltonSequence")
+        .def(py::init<int, uint64_t>(), py::arg("dimension"), py::arg("seed") = 0)
+        .def_property_readonly("dimension", &HaltonSequence::dimension)
+        .def("next", &HaltonSequence::next)
+        .def("reset", &HaltonSequence::reset);
+
+    py::enum_<SamplingMode>(m, "SamplingMode")
+        .value("uniform", SamplingMode::uniform)
+        .value("halton", SamplingMode::halton);
+
     py::class_<SearchSpace, PySearchSpace>(m, "SearchSpace")
         .def(py::init<int>())
-        .def("sample_free_space", &SearchSpace::sample_free_space)
+        .def_property_readonly("sampling_mode", &SearchSpace::get_sampling_mode)
+        .def("set_sampling_mode", &SearchSpace::set_sampling_mode, py::arg("mode"), py::arg("seed") = -1)
+        .def("sample_free_space", py::overload_cast<int>(&SearchSpace::sample_free_space, py::const_))
+        .def("sample_free_space", py::overload_cast<int, RandomStream&>(&SearchSpace::sample_free_space, py::const_))
+        .def("sample_space", &SearchSpace::sample_space)
+        .def("valid_state", &SearchSpace::valid_state)
+        .def("valid_states", &SearchSpace::valid_states)
         .def("valid_transition", &SearchSpace::valid_transition)
-        .def("transition_cost", &SearchSpace::transition_cost);
+        .def("transition_cost", &SearchSpace::transition_cost)
+        .def("interpolate", &SearchSpace::interpolate)
+        .def("sampling_volume", &SearchSpace::sampling_volume)
+        .def("valid_transitions", &SearchSpace::valid_transitions)
+        .def("transition_costs", &SearchSpace::transition_costs);
+
+    m.def("sample_gaussian", &sample_gaussian);
+    m.def("sample_bridge", &sample_bridge);
+
+    py::class_<FreeSpaceRaster>(m, "FreeSpaceRaster")
+        .def_property_readonly("empty", &FreeSpaceRaster::empty)
+        .def_property_readonly("n_free_cells", &FreeSpaceRaster::n_free_cells)
+        .def_property_readonly("n_mixed_cells", &FreeSpaceRaster::n_mixed_cells)
+        .def_property_readonly("n_blocked_cells", &FreeSpaceRaster::n_blocked_cells);
 
     py::class_<PolygonSpace, SearchSpace>(m, "PolygonSpace")
-        .def(py::init<std::vector<Polygon>, std::pair<double, double>, std::pair<double, double>>());
+        .def(py::init<std::vector<Polygon>, std::pair<double, double>, std::pair<double, double>, long>(),
+            py::arg("polygons"), py::arg("xrange"), py::arg("yrange"), py::arg("seed") = -1)
+        .def("set_free_space_raster", &PolygonSpace::set_free_space_raster, py::arg("resolution"))
+        .def_property_readonly("free_space_raster", &PolygonSpace::get_free_space_raster, py::return_value_policy::reference_internal);
+
+    py::class_<GridSpace, SearchSpace>(m, "GridSpace")
+        .def(py::init<OccupancyGrid, double, Eigen::Vector2d, long>(),
+            py::arg("occupancy"), py::arg("resolution"), py::arg("origin") = Eigen::Vector2d::Zero(), py::arg("seed") = -1)
+        .def("distance_field", &GridSpace::distance_field)
+        .def_property_readonly("occupancy", &GridSpace::get_occupancy)
+        .def_property_readonly("resolution", &GridSpace::get_resolution)
+        .def_property_readonly("origin", &GridSpace::get_origin)
+        .def_property_readonly("n_free_cells", &GridSpace::n_free_cells);
+
+    py::class_<MeshSpace, SearchSpace>(m, "MeshSpace")
+        .def(py::init<std::vector<TriangleMesh>, std::pair<double, double>, std::pair<double, double>, std::pair<double, double>, long>(),
+            py::arg("meshes"), py::arg("xrange"), py::arg("yrange"), py::arg("zrange"), py::arg("seed") = -1)
+        .def_property_readonly("meshes", &MeshSpace::get_meshes);
+
+    py::class_<BoxSpace, SearchSpace>(m, "BoxSpace")
+        .def(py::init<Eigen::MatrixXd, Eigen::MatrixXd, Eigen::VectorXd, Eigen::VectorXd, long>(),
+            py::arg("box_lower"), py::arg("box_upper"), py::arg("lower"), py::arg("upper"), py::arg("seed") = -1)
+        .def_property_readonly("box_lower", &BoxSpace::get_box_lower)
+        .def_property_readonly("box_upper", &BoxSpace::get_box_upper)
+        .def_property_readonly("lower", &BoxSpace::get_lower)
+        .def_property_readonly("upper", &BoxSpace::get_upper)
+        .def_property_readonly("n_boxes", &BoxSpace::n_boxes)
+        .def_property_readonly("is_indexed", &BoxSpace::is_indexed);
+
+    py::class_<SE2PolygonSpace, SearchSpace>(m, "SE2PolygonSpace")
+        .def(py::init<Polygon, std::vector<Polygon>, std::pair<double, double>, std::pair<double, double>, double, long>(),
+            py::arg("footprint"), py::arg("obstacles"), py::arg("xrange"), py::arg("yrange"), py::arg("rotation_weight") = -1.,
+            py::arg("seed") = -1)
+        .def("footprint_at", &SE2PolygonSpace::footprint_at)
+        .def("clearance", &SE2PolygonSpace::clearance, py::arg("state"), py::arg("limit"))
+        .def_property_readonly("footprint", &SE2PolygonSpace::get_footprint)
+        .def_property_readonly("obstacles", &SE2PolygonSpace::get_obstacles)
+        .def_property_readonly("rotation_weight", &SE2PolygonSpace::get_rotation_weight);
+
+    m.def("wrap_angle", &wrap_angle);
+
+    py::register_exception<NoFreeSpaceException>(m, "NoFreeSpaceException");
+    py::register_exception<NoStateCheckException>(m, "NoStateCheckException");
+    py::register_exception<BadBoxException>(m, "BadBoxException");
+    py::register_exception<BadFootprintException>(m, "BadFootprintException");
 }
\ No newline at end of file
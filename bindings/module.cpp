@@ -6,9 +6,13 @@
 
 namespace py = pybind11;
 
+void init_contraction_hierarchy(py::module_ &);
 void init_geometry(py::module_ &);
+void init_incremental_planner(py::module_ &);
 void init_kd_tree(py::module_ &);
+void init_resumable_search(py::module_ &);
 void init_roadmap(py::module_ &);
+void init_rrt_connect(py::module_ &);
 void init_search_space(py::module_ &);
 
 PYBIND11_MODULE(_navitools, m)
@@ -17,4 +21,8 @@ PYBIND11_MODULE(_navitools, m)
     init_kd_tree(m);
     init_roadmap(m);
     init_search_space(m);
+    init_contraction_hierarchy(m);
+    init_incremental_planner(m);
+    init_resumable_search(m);
+    init_rrt_connect(m);
 }
\ No newline at end of file
@@ -3,7 +3,7 @@ from random import uniform
 from typing import List, Tuple
 
 import numpy as np
-from navitools import Polygon
+from navitools import Polygon, PolygonSpace, Roadmap
 
 
 def generate_test_points(n: int = 1_000, size: int = 2, min_val: float = -100, max_val: float = 100) -> np.ndarray:
@@ -38,3 +38,21 @@ def make_random_triangles(n: int, xrange: Tuple[float, float] = (0, 50), yrange:
         triangles.append(Polygon(points))
 
     return triangles
+
+
+def path_cost(roadmap: Roadmap, path: np.ndarray) -> float:
+    cost = 0.
+    for a, b in zip(path[:-1], path[1:]):
+        node = roadmap.node_at(a)
+        cost += min(c for neighbor, c in zip(node.neighbors, node.costs) if np.all(neighbor == b))
+
+    return cost
+
+
+def make_wall_with_gap(gap: float, xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)) \
+        -> PolygonSpace:
+    # Wall across the middle of the map, past its edges, with a gap around y = 0 if gap > 0
+    lower = Polygon(np.array([[-1., yrange[0] - 1.], [1., yrange[0] - 1.], [1., -gap / 2], [-1., -gap / 2]]))
+    upper = Polygon(np.array([[-1., gap / 2], [1., gap / 2], [1., yrange[1] + 1.], [-1., yrange[1] + 1.]]))
+
+    return PolygonSpace([lower, upper], xrange, yrange)
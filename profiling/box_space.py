@@ -0,0 +1,92 @@
+from typing import Tuple
+
+import numpy as np
+from navitools import BoxSpace, RandomStream, SearchSpace, build_prm
+
+from reporting import pretty_print_statistics, pretty_print_title, profile_function
+
+
+def make_random_boxes(n: int, dimension: int, extent: float, max_size: float) -> Tuple[np.ndarray, np.ndarray]:
+    stream = RandomStream(0)
+    box_lower = extent * stream.uniform_block(n, dimension)
+    box_upper = box_lower + max_size * stream.uniform_block(n, dimension)
+
+    return box_lower, box_upper
+
+
+class PythonBoxSpace(SearchSpace):
+    """The same space written as a Python subclass, with numpy doing the work in the batch forms"""
+
+    def __init__(self, box_lower: np.ndarray, box_upper: np.ndarray, extent: float):
+        super().__init__(box_lower.shape[1])
+        self.box_lower, self.box_upper, self.extent = box_lower, box_upper, extent
+
+    def in_collision(self, states: np.ndarray) -> np.ndarray:
+        inside = (self.box_lower <= states[:, None]) & (states[:, None] <= self.box_upper)
+        return np.any(np.all(inside, axis=2), axis=1)
+
+    def sample_free_space(self, n: int) -> np.ndarray:
+        samples = np.empty((0, self.box_lower.shape[1]))
+        while len(samples) < n:
+            candidates = np.random.uniform(0, self.extent, (n, self.box_lower.shape[1]))
+            samples = np.vstack([samples, candidates[~self.in_collision(candidates)]])
+
+        return samples[:n]
+
+    def valid_transitions(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+        direction = (b - a)[:, None]
+        with np.errstate(divide='ignore', invalid='ignore'):
+            t_lower, t_upper = (self.box_lower - a[:, None]) / direction, (self.box_upper - a[:, None]) / direction
+
+        inside = (self.box_lower <= a[:, None]) & (a[:, None] <= self.box_upper)
+        t_near = np.where(direction == 0, np.where(inside, -np.inf, np.inf), np.minimum(t_lower, t_upper)).max(axis=2)
+        t_far = np.where(direction == 0, np.where(inside, np.inf, -np.inf), np.maximum(t_lower, t_upper)).min(axis=2)
+
+        return ~np.any(np.maximum(t_near, 0.) <= np.minimum(t_far, 1.), axis=1)
+
+    def transition_costs(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+        return np.einsum('ij,ij->i', b - a, b - a)
+
+
+def profile_box_space(box_counts: Tuple[int, ...] = (10, 100, 1_000, 10_000), dimensions: Tuple[int, ...] = (2, 3, 6),
+                      n_queries: int = 10_000, segment_length: float = 2., extent: float = 50., n_trials: int = 5):
+
+    pretty_print_title(f'Profiling BoxSpace queries against the number of boxes: {n_queries} queries')
+    print(f'    {"Dimension":>10}{"Boxes":>8}{"Indexed":>9}{"State (us)":>14}{"Transition (us)":>18}')
+
+    for dimension in dimensions:
+        stream = RandomStream(1)
+        starts = extent * stream.uniform_block(n_queries, dimension)
+        ends = starts + segment_length * (stream.uniform_block(n_queries, dimension) - 0.5)
+        bounds = np.zeros(dimension), np.full(dimension, extent)
+
+        # Boxes grow with the dimension, so that they still fill a share of the space
+        max_size = extent * 0.05 ** (2 / dimension)
+
+        for n_boxes in box_counts:
+            search_space = BoxSpace(*make_random_boxes(n_boxes, dimension, extent, max_size), *bounds)
+
+            state_time = np.median(profile_function(n_trials, search_space.valid_states, (starts,)))
+            transition_time = np.median(profile_function(n_trials, search_space.valid_transitions, (starts, ends)))
+
+            print(f'    {dimension:>10}{n_boxes:>8}{str(search_space.is_indexed):>9}{1e6 * state_time / n_queries:>14.3f}'
+                  f'{1e6 * transition_time / n_queries:>18.3f}')
+
+
+def profile_box_space_prm(n_boxes: int = 200, dimension: int = 6, n_samples: int = 2_000, n_batch: int = 100,
+                          k_neighbors: int = 10, extent: float = 50., n_trials: int = 3):
+
+    box_lower, box_upper = make_random_boxes(n_boxes, dimension, extent, 20.)
+    bounds = np.zeros(dimension), np.full(dimension, extent)
+
+    # build_prm never calls back into Python for the native space
+    for name, search_space in (('BoxSpace', BoxSpace(box_lower, box_upper, *bounds)),
+                               ('Python subclass', PythonBoxSpace(box_lower, box_upper, extent))):
+        pretty_print_title(f'Profiling build_prm in a {dimension}D {name}: {n_boxes} boxes, {n_samples} samples')
+        runtimes = profile_function(n_trials, build_prm, (n_samples, n_batch, k_neighbors, search_space))
+        pretty_print_statistics(runtimes)
+
+
+if __name__ == '__main__':
+    profile_box_space()
+    profile_box_space_prm()
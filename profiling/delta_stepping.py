@@ -0,0 +1,43 @@
+import os
+import random
+from math import ceil
+from typing import Tuple
+
+from navitools import PolygonSpace, build_prm, delta_stepping, dijkstra_costs
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_statistics, pretty_print_title, profile_function
+
+
+def profile_delta_stepping(n_samples: int = 200_000, n_batch: int = 100, k_neighbors: int = 10,
+                           min_n_vertices: int = 100, xrange: Tuple[float, float] = (-10, 10),
+                           yrange: Tuple[float, float] = (-10, 10), n_trials: int = 10):
+
+    n_triangles = ceil(min_n_vertices / 3)
+    triangles = make_random_triangles(n_triangles, xrange, yrange)
+
+    search_space = PolygonSpace(triangles, xrange, yrange)
+
+    roadmap = build_prm(n_samples, n_batch, k_neighbors, search_space)
+    source = random.choice(roadmap.states)
+
+    runtimes = profile_function(n_trials, dijkstra_costs, (roadmap, source))
+
+    pretty_print_title(f'Profiling single-source shortest paths: {roadmap.n_states} nodes')
+    print('Dijkstra')
+    pretty_print_statistics(runtimes)
+    baseline = runtimes.mean()
+
+    # Scaling from one core up to all of them
+    n_threads = 1
+    while n_threads <= os.cpu_count():
+        runtimes = profile_function(n_trials, delta_stepping, (roadmap, source, n_threads))
+
+        print(f'Delta-stepping, {n_threads} threads (speedup over Dijkstra: {baseline / runtimes.mean():.2f}x)')
+        pretty_print_statistics(runtimes)
+
+        n_threads *= 2
+
+
+if __name__ == '__main__':
+    profile_delta_stepping()
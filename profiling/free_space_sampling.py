@@ -0,0 +1,34 @@
+from math import ceil
+from typing import Tuple
+
+import numpy as np
+from navitools import PolygonSpace, RandomStream
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_statistics, pretty_print_title, profile_function
+
+
+def profile_free_space_raster(n_samples: int = 100_000, min_n_vertices: int = 3_000, resolution: int = 256,
+                              xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10),
+                              n_trials: int = 10):
+
+    n_triangles = ceil(min_n_vertices / 3)
+    triangles = make_random_triangles(n_triangles, xrange, yrange)
+
+    search_space = PolygonSpace(triangles, xrange, yrange)
+    stream = RandomStream(0)
+
+    pretty_print_title(f'Profiling rejection sampling: {n_samples} samples in space with {n_triangles * 3} vertices')
+    pretty_print_statistics(profile_function(n_trials, search_space.sample_free_space, (n_samples, stream)))
+
+    build_time = profile_function(1, search_space.set_free_space_raster, (resolution,))[0]
+    raster = search_space.free_space_raster
+
+    pretty_print_title(f'Profiling raster sampling: {resolution} cells across, built in {build_time:.3f} s, with '
+                       f'{raster.n_free_cells} free, {raster.n_mixed_cells} mixed and {raster.n_blocked_cells} '
+                       f'blocked cells')
+    pretty_print_statistics(profile_function(n_trials, search_space.sample_free_space, (n_samples, stream)))
+
+
+if __name__ == '__main__':
+    profile_free_space_raster()
@@ -0,0 +1,53 @@
+from typing import Tuple
+
+import numpy as np
+from navitools import GridSpace, Polygon, PolygonSpace, RandomStream
+
+from reporting import pretty_print_title, profile_function
+
+
+def make_polygon_space(occupancy: np.ndarray, resolution: float) -> PolygonSpace:
+    squares = [Polygon(resolution * np.array([[j, i], [j + 1, i], [j + 1, i + 1], [j, i + 1]], dtype=float))
+               for i, j in zip(*np.nonzero(occupancy))]
+
+    # Clockwise, so everything outside the map is an obstacle, as it is for the grid
+    width, height = resolution * occupancy.shape[1], resolution * occupancy.shape[0]
+    boundary = Polygon(np.array([[0., height], [width, height], [width, 0.], [0., 0.]]))
+
+    return PolygonSpace(squares + [boundary], (0, width), (0, height))
+
+
+def profile_grid_space(shape: Tuple[int, int] = (512, 512), densities: Tuple[float, ...] = (0.001, 0.01, 0.05),
+                       n_queries: int = 20_000, segment_lengths: Tuple[float, ...] = (2., 20.),
+                       resolution: float = 0.1, n_trials: int = 5):
+
+    pretty_print_title(f'Profiling GridSpace against PolygonSpace on the same map: {shape[0]}x{shape[1]} cells, '
+                       f'{n_queries} queries')
+    print(f'    {"Density":>8}{"Length":>8}{"Space":>14}{"Build (ms)":>12}{"Transition (us)":>18}')
+
+    for density in densities:
+        occupancy = RandomStream(0).uniform_block(*shape) < density
+
+        # Building the polygon space also has to turn every occupied cell into a polygon
+        grid_build_time = np.median(profile_function(n_trials, GridSpace, (occupancy, resolution)))
+        polygon_build_time = np.median(profile_function(n_trials, make_polygon_space, (occupancy, resolution)))
+
+        grid_space = GridSpace(occupancy, resolution, seed=0)
+        polygon_space = make_polygon_space(occupancy, resolution)
+
+        # Long transitions through sparse maps are where the distance field's long steps pay off
+        for segment_length in segment_lengths:
+            stream = RandomStream(1)
+            starts = grid_space.sample_free_space(n_queries, stream)
+            ends = starts + segment_length * (stream.uniform_block(n_queries, 2) - 0.5)
+
+            for name, search_space, build_time in (('GridSpace', grid_space, grid_build_time),
+                                                   ('PolygonSpace', polygon_space, polygon_build_time)):
+                transition_time = np.median(profile_function(n_trials, search_space.valid_transitions, (starts, ends)))
+
+                print(f'    {density:>8}{segment_length:>8}{name:>14}{1e3 * build_time:>12.2f}'
+                      f'{1e6 * transition_time / n_queries:>18.3f}')
+
+
+if __name__ == '__main__':
+    profile_grid_space()
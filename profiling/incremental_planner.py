@@ -0,0 +1,63 @@
+import random
+from math import ceil
+from typing import Tuple
+
+import numpy as np
+from navitools import IncrementalPlanner, PolygonSpace, SearchStatistics, build_prm
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_title
+
+
+def profile_incremental_planner(n_samples: int = 50_000, n_batch: int = 10, k_neighbors: int = 10,
+                                min_n_vertices: int = 100, xrange: Tuple[float, float] = (-10, 10),
+                                yrange: Tuple[float, float] = (-10, 10), n_trials: int = 20, n_blocked: int = 5):
+
+    n_triangles = ceil(min_n_vertices / 3)
+    triangles = make_random_triangles(n_triangles, xrange, yrange)
+
+    search_space = PolygonSpace(triangles, xrange, yrange)
+
+    roadmap = build_prm(n_samples, n_batch, k_neighbors, search_space)
+
+    repaired_expansions, fresh_expansions = [], []
+    for _ in range(n_trials):
+        start, goal = random.choices(roadmap.states, k=2)
+
+        planner = IncrementalPlanner(roadmap, start, goal)
+        path = planner.plan()
+
+        blocked = []
+        for _ in range(n_blocked):
+            if len(path) < 2:
+                break
+
+            i = random.randrange(len(path) - 1)
+            blocked.append((path[i], path[i + 1]))
+            planner.set_edge_cost(path[i], path[i + 1], np.inf)
+
+            statistics = SearchStatistics()
+            path = planner.plan(statistics)
+            repaired_expansions.append(statistics.n_expansions)
+
+            fresh = IncrementalPlanner(roadmap, start, goal)
+            for a, b in blocked:
+                fresh.set_edge_cost(a, b, np.inf)
+
+            statistics = SearchStatistics()
+            fresh.plan(statistics)
+            fresh_expansions.append(statistics.n_expansions)
+
+    repaired_expansions = np.array(repaired_expansions)
+    fresh_expansions = np.array(fresh_expansions)
+
+    pretty_print_title(f'Profiling incremental replanning after blocking path edges: {roadmap.n_states} nodes')
+    print(
+        f'    Mean node expansions, repaired search: {repaired_expansions.mean():.1f}\n'
+        f'    Mean node expansions, fresh search: {fresh_expansions.mean():.1f}\n'
+        f'    Fraction of a fresh search: {repaired_expansions.sum() / fresh_expansions.sum():.3f}\n'
+    )
+
+
+if __name__ == '__main__':
+    profile_incremental_planner()
@@ -0,0 +1,65 @@
+import random
+import time
+from math import ceil
+from typing import Tuple
+
+import numpy as np
+from navitools import PolygonSpace, SearchStatistics, alt_search, build_prm, dijkstra
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_statistics, pretty_print_title
+
+
+def profile_landmark_search(n_samples: int = 5000, n_batch: int = 10, k_neighbors: int = 10, n_landmarks: int = 8,
+                            min_n_vertices: int = 100, xrange: Tuple[float, float] = (-10, 10),
+                            yrange: Tuple[float, float] = (-10, 10), n_trials: int = 100):
+
+    n_triangles = ceil(min_n_vertices / 3)
+    triangles = make_random_triangles(n_triangles, xrange, yrange)
+
+    search_space = PolygonSpace(triangles, xrange, yrange)
+
+    roadmap = build_prm(n_samples, n_batch, k_neighbors, search_space)
+
+    start = time.time()
+    roadmap.preprocess_landmarks(n_landmarks)
+    preprocessing_time = time.time() - start
+
+    queries = [random.choices(roadmap.states, k=2) for _ in range(n_trials)]
+
+    def run_queries(search):
+        runtimes, expansions = [], []
+        for start_state, goal_state in queries:
+            statistics = SearchStatistics()
+
+            start = time.time()
+            search(roadmap, start_state, goal_state, statistics)
+            runtimes.append(time.time() - start)
+
+            expansions.append(statistics.n_expansions)
+
+        return np.array(runtimes), np.array(expansions)
+
+    dijkstra_runtimes, dijkstra_expansions = run_queries(dijkstra)
+    alt_runtimes, alt_expansions = run_queries(alt_search)
+
+    pretty_print_title(
+        f'Profiling landmark (ALT) search: {roadmap.n_states} nodes, {n_landmarks} landmarks, '
+        f'preprocessed in {preprocessing_time:.3f} s')
+
+    print('Dijkstra runtimes')
+    pretty_print_statistics(dijkstra_runtimes)
+
+    print('ALT runtimes')
+    pretty_print_statistics(alt_runtimes)
+
+    print(
+        f'    Mean node expansions, Dijkstra: {dijkstra_expansions.mean():.1f}\n'
+        f'    Mean node expansions, ALT: {alt_expansions.mean():.1f}\n'
+        f'    Expansion ratio: {dijkstra_expansions.sum() / max(alt_expansions.sum(), 1):.1f}x\n'
+        f'    Wall time ratio: {dijkstra_runtimes.sum() / alt_runtimes.sum():.1f}x\n'
+    )
+
+
+if __name__ == '__main__':
+    profile_landmark_search()
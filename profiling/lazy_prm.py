@@ -0,0 +1,68 @@
+import random
+import time
+from math import ceil
+from typing import Tuple
+
+import numpy as np
+from navitools import PolygonSpace, Roadmap, SearchStatistics, alt_search, extend_prm, lazy_search
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_statistics, pretty_print_title
+
+
+def profile_lazy_prm(n_nodes: int = 5000, n_batch: int = 50, k_neighbors: int = 10, min_n_vertices: int = 300,
+                     xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10),
+                     n_trials: int = 50):
+
+    n_triangles = ceil(min_n_vertices / 3)
+    search_space = PolygonSpace(make_random_triangles(n_triangles, xrange, yrange), xrange, yrange, seed=0)
+
+    # extend_prm counts nodes rather than kept edges like build_prm, so both roadmaps have the same nodes' worth of work
+    def build(lazy: bool) -> Tuple[Roadmap, float]:
+        roadmap = Roadmap(2)
+
+        start = time.time()
+        extend_prm(roadmap, n_nodes, n_batch, k_neighbors, search_space, lazy=lazy)
+
+        return roadmap, time.time() - start
+
+    eager, eager_build_time = build(False)
+    lazy, lazy_build_time = build(True)
+
+    def run_queries(roadmap: Roadmap, search) -> Tuple[np.ndarray, np.ndarray]:
+        runtimes, edge_checks = [], []
+        for _ in range(n_trials):
+            start_state, goal_state = random.choices(roadmap.states, k=2)
+            statistics = SearchStatistics()
+
+            start = time.time()
+            search(roadmap, start_state, goal_state, statistics)
+            runtimes.append(time.time() - start)
+
+            edge_checks.append(statistics.n_edge_checks)
+
+        return np.array(runtimes), np.array(edge_checks)
+
+    eager_runtimes, _ = run_queries(eager, alt_search)
+    lazy_runtimes, lazy_edge_checks = run_queries(lazy, lambda *args: lazy_search(args[0], search_space, *args[1:]))
+
+    pretty_print_title(f'Profiling lazy PRM: {n_nodes} nodes, {k_neighbors} neighbors, {n_triangles} triangles')
+
+    print('Eager roadmap, search runtimes')
+    pretty_print_statistics(eager_runtimes)
+
+    print('Lazy roadmap, lazy search runtimes (including the edge checks)')
+    pretty_print_statistics(lazy_runtimes)
+
+    print(
+        f'    Build time, eager: {eager_build_time:.3f} s\n'
+        f'    Build time, lazy: {lazy_build_time:.3f} s\n'
+        f'    Build time ratio: {eager_build_time / lazy_build_time:.1f}x\n'
+        f'    Mean edge checks per lazy search: {lazy_edge_checks.mean():.1f}\n'
+        f'    Build and {n_trials} queries, eager: {eager_build_time + eager_runtimes.sum():.3f} s\n'
+        f'    Build and {n_trials} queries, lazy: {lazy_build_time + lazy_runtimes.sum():.3f} s\n'
+    )
+
+
+if __name__ == '__main__':
+    profile_lazy_prm()
@@ -0,0 +1,48 @@
+from math import ceil
+from typing import Tuple
+
+import numpy as np
+from navitools import PolygonSpace, Roadmap, SamplingMode, extend_prm
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_title
+
+
+def largest_component_fraction(roadmap: Roadmap) -> float:
+    return np.bincount(roadmap.component_labels).max() / roadmap.n_states
+
+
+def profile_nodes_to_connectivity(node_counts: Tuple[int, ...] = (100, 200, 400, 800, 1600), n_batch: int = 50,
+                                  k_neighbors: int = 10, min_n_vertices: int = 300,
+                                  xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10),
+                                  n_maps: int = 10):
+
+    n_triangles = ceil(min_n_vertices / 3)
+
+    pretty_print_title(f'Profiling connectivity against roadmap size: {n_maps} maps with {n_triangles * 3} vertices')
+    print(f'    {"Nodes":>8}{"Mode":>10}{"Components":>14}{"Largest component":>20}')
+
+    results = {(n, mode): [] for n in node_counts for mode in SamplingMode.__members__.values()}
+
+    for seed in range(n_maps):
+        triangles = make_random_triangles(n_triangles, xrange, yrange)
+
+        for mode in SamplingMode.__members__.values():
+            for n in node_counts:
+                search_space = PolygonSpace(triangles, xrange, yrange, seed=seed)
+                search_space.set_sampling_mode(mode, seed=seed)
+
+                # extend_prm counts nodes, where build_prm counts edges
+                roadmap = Roadmap(2)
+                extend_prm(roadmap, n, n_batch, k_neighbors, search_space)
+
+                results[n, mode].append((roadmap.count_components(), largest_component_fraction(roadmap)))
+
+    for n in node_counts:
+        for mode in SamplingMode.__members__.values():
+            n_components, largest = np.mean(results[n, mode], axis=0)
+            print(f'    {n:>8}{mode.name:>10}{n_components:>14.1f}{largest:>20.3f}')
+
+
+if __name__ == '__main__':
+    profile_nodes_to_connectivity()
@@ -0,0 +1,63 @@
+from typing import Tuple
+
+import numpy as np
+from navitools import MeshSpace, RandomStream, TriangleMesh, build_prm
+
+from reporting import pretty_print_statistics, pretty_print_title, profile_function
+
+
+BOX_FACES = np.array([[0, 1, 3], [0, 3, 2], [4, 6, 7], [4, 7, 5], [0, 4, 5], [0, 5, 1],
+                      [2, 3, 7], [2, 7, 6], [0, 2, 6], [0, 6, 4], [1, 5, 7], [1, 7, 3]])
+
+
+def make_random_boxes(n: int, extent: float, max_size: float = 2.) -> list:
+    stream = RandomStream(0)
+    boxes = []
+    for _ in range(n):
+        lower = np.array([stream.uniform(0, extent) for _ in range(3)])
+        upper = lower + np.array([stream.uniform(0.1, max_size) for _ in range(3)])
+        vertices = np.array([[x, y, z] for x in (lower[0], upper[0]) for y in (lower[1], upper[1]) for z in (lower[2], upper[2])])
+        boxes.append(TriangleMesh(vertices, BOX_FACES))
+
+    return boxes
+
+
+def profile_mesh_space(mesh_counts: Tuple[int, ...] = (10, 100, 1_000, 10_000), n_queries: int = 10_000,
+                       segment_length: float = 2., extent: float = 50., n_trials: int = 5):
+
+    stream = RandomStream(1)
+    starts = extent * stream.uniform_block(n_queries, 3)
+    ends = starts + segment_length * (stream.uniform_block(n_queries, 3) - 0.5)
+
+    pretty_print_title(f'Profiling MeshSpace queries against the number of box meshes: {n_queries} queries')
+    print(f'    {"Meshes":>10}{"Build (ms)":>12}{"State (us)":>14}{"Transition (us)":>18}')
+
+    # The bounding volume hierarchy keeps the cost of a query close to logarithmic in the number of triangles
+    for n_meshes in mesh_counts:
+        boxes = make_random_boxes(n_meshes, extent)
+        bounds = (0, extent)
+
+        build_time = np.median(profile_function(n_trials, MeshSpace, (boxes, bounds, bounds, bounds)))
+        search_space = MeshSpace(boxes, bounds, bounds, bounds)
+
+        state_time = np.median(profile_function(n_trials, search_space.valid_states, (starts,)))
+        transition_time = np.median(profile_function(n_trials, search_space.valid_transitions, (starts, ends)))
+
+        print(f'    {n_meshes:>10}{1e3 * build_time:>12.2f}{1e6 * state_time / n_queries:>14.3f}'
+              f'{1e6 * transition_time / n_queries:>18.3f}')
+
+
+def profile_mesh_space_prm(n_meshes: int = 300, n_samples: int = 3_000, n_batch: int = 100, k_neighbors: int = 10,
+                           extent: float = 20., n_trials: int = 5):
+
+    bounds = (0, extent)
+    search_space = MeshSpace(make_random_boxes(n_meshes, extent), bounds, bounds, bounds, seed=0)
+
+    pretty_print_title(f'Profiling build_prm in a MeshSpace: {n_meshes} boxes, {n_samples} samples')
+    runtimes = profile_function(n_trials, build_prm, (n_samples, n_batch, k_neighbors, search_space))
+    pretty_print_statistics(runtimes)
+
+
+if __name__ == '__main__':
+    profile_mesh_space()
+    profile_mesh_space_prm()
@@ -0,0 +1,49 @@
+from typing import Tuple
+
+import numpy as np
+from navitools import Roadmap, SamplingMix, build_prm
+from navitools.testing import make_wall_with_gap
+
+from reporting import pretty_print_title
+
+
+def sides_connected(roadmap: Roadmap) -> bool:
+    labels = roadmap.component_labels
+    states = roadmap.states
+
+    left = labels[states[:, 0] < -1]
+    right = labels[states[:, 0] > 1]
+
+    return left.size and right.size and np.bincount(left).argmax() == np.bincount(right).argmax()
+
+
+def profile_narrow_passage(sizes: Tuple[int, ...] = (1_250, 2_500, 5_000, 10_000), gap: float = 0.3,
+                           n_batch: int = 50, k_neighbors: int = 10, xrange: Tuple[float, float] = (-10, 10),
+                           yrange: Tuple[float, float] = (-10, 10), n_trials: int = 20):
+
+    search_space = make_wall_with_gap(gap, xrange, yrange)
+    mixes = {
+        'uniform': SamplingMix(),
+        'gaussian': SamplingMix(gaussian_ratio=0.3, sigma=gap),
+        'bridge': SamplingMix(bridge_ratio=0.3, sigma=gap),
+        'mixed': SamplingMix(gaussian_ratio=0.1, bridge_ratio=0.2, sigma=gap),
+    }
+
+    pretty_print_title(f'Profiling connectivity through a {gap} wide gap: {n_trials} roadmaps per size')
+    print(f'    {"Samples":>8}{"Nodes":>8}' + ''.join(f'{name:>10}' for name in mixes))
+
+    for n_samples in sizes:
+        connected = {name: 0 for name in mixes}
+        n_nodes = 0
+
+        for seed in range(n_trials):
+            for name, mix in mixes.items():
+                roadmap = build_prm(n_samples, n_batch, k_neighbors, search_space, seed=seed, mix=mix)
+                connected[name] += sides_connected(roadmap)
+                n_nodes = roadmap.n_states
+
+        print(f'    {n_samples:>8}{n_nodes:>8}' + ''.join(f'{connected[name] / n_trials:>10.2f}' for name in mixes))
+
+
+if __name__ == '__main__':
+    profile_narrow_passage()
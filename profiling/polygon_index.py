@@ -0,0 +1,33 @@
+from typing import Tuple
+
+import numpy as np
+from navitools import PolygonSpace, RandomStream
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_title, profile_function
+
+
+def profile_polygon_index(obstacle_counts: Tuple[int, ...] = (10, 100, 1_000, 10_000), n_queries: int = 10_000,
+                          segment_length: float = 2., xrange: Tuple[float, float] = (-50, 50),
+                          yrange: Tuple[float, float] = (-50, 50), n_trials: int = 5):
+
+    stream = RandomStream(0)
+    starts = np.column_stack([[stream.uniform(*xrange) for _ in range(n_queries)],
+                              [stream.uniform(*yrange) for _ in range(n_queries)]])
+    ends = starts + segment_length * (stream.uniform_block(n_queries, 2) - 0.5)
+
+    pretty_print_title(f'Profiling PolygonSpace queries against obstacle count: {n_queries} queries')
+    print(f'    {"Obstacles":>10}{"State (us)":>14}{"Transition (us)":>18}')
+
+    # With the grid index the cost of a query depends on the obstacles near it, not on how many there are
+    for n_obstacles in obstacle_counts:
+        search_space = PolygonSpace(make_random_triangles(n_obstacles, xrange, yrange), xrange, yrange)
+
+        state_time = np.median(profile_function(n_trials, search_space.valid_states, (starts,)))
+        transition_time = np.median(profile_function(n_trials, search_space.valid_transitions, (starts, ends)))
+
+        print(f'    {n_obstacles:>10}{1e6 * state_time / n_queries:>14.3f}{1e6 * transition_time / n_queries:>18.3f}')
+
+
+if __name__ == '__main__':
+    profile_polygon_index()
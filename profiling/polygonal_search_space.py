@@ -43,17 +43,18 @@ def profile_sampling(n_samples: int = 1_000, min_n_vertices: int = 1_000, xrange
 
 def profile_build_prm(n_samples: int = 100, n_batch: int = 10, k_neighbors: int = 10, min_n_vertices: int = 100,
                       xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10),
-                      n_trials: int = 10, plot: bool = False):
+                      n_trials: int = 10, n_threads: int = 1, plot: bool = False):
 
     n_triangles = ceil(min_n_vertices / 3)
     triangles = make_random_triangles(n_triangles, xrange, yrange)
 
     search_space = PolygonSpace(triangles, xrange, yrange)
 
-    runtimes = profile_function(n_trials, build_prm, (n_samples, n_batch, k_neighbors, search_space))
+    runtimes = profile_function(n_trials, build_prm, (n_samples, n_batch, k_neighbors, search_space, n_threads))
 
     pretty_print_title(
-        f'Profiling building PRM in polygon space: {n_samples} samples in space with {n_triangles * 3} vertices')
+        f'Profiling building PRM in polygon space: {n_samples} samples in space with {n_triangles * 3} vertices, '
+        f'{n_threads} threads')
     pretty_print_statistics(runtimes)
 
     if plot:
@@ -0,0 +1,53 @@
+from typing import Tuple
+
+import numpy as np
+from navitools import Polygon, RandomStream, inside_polygons, segments_intersect_polygons
+
+from reporting import pretty_print_title, profile_function
+
+
+def make_regular_polygons(n_polygons: int, xrange: Tuple[float, float], yrange: Tuple[float, float],
+                          stream: RandomStream):
+    polygons = []
+    for k in range(n_polygons):
+        n_points = 3 + k % 10
+        angles = np.linspace(0, 2 * np.pi, n_points, endpoint=False) - np.pi / 2 + 0.01
+        center = np.array([stream.uniform(*xrange), stream.uniform(*yrange)])
+        polygons.append(Polygon(center + 0.5 * np.column_stack([np.cos(angles), np.sin(angles)])))
+
+    return polygons
+
+
+def profile_robust_predicates(n_polygons: int = 300, n_queries: int = 200_000,
+                              xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10),
+                              n_trials: int = 5):
+
+    stream = RandomStream(0)
+    polygons = make_regular_polygons(n_polygons, xrange, yrange, stream)
+
+    random_points = np.column_stack([[stream.uniform(*xrange) for _ in range(n_queries)],
+                                     [stream.uniform(*yrange) for _ in range(n_queries)]])
+
+    # Points on the facets, where the orientation tests are nearly degenerate and fall back to exact arithmetic
+    facet_points = np.empty((n_queries, 2))
+    for i in range(n_queries):
+        polygon = polygons[i % n_polygons]
+        j = i % polygon.n_points
+        facet_points[i] = polygon[j] + stream.uniform(0, 1) * (polygon[j + 1] - polygon[j])
+
+    ends = random_points + 2 * (stream.uniform_block(n_queries, 2) - 0.5)
+
+    pretty_print_title(f'Profiling exact predicates: {n_queries} queries against {n_polygons} polygons, on one thread')
+    print(f'    {"Queries":>16}{"Points (ns)":>14}{"Segments (ns)":>16}')
+
+    for name, points in (('Random', random_points), ('On facets', facet_points)):
+        segments = np.hstack([points, ends])
+
+        point_time = np.median(profile_function(n_trials, inside_polygons, (points, polygons, 1)))
+        segment_time = np.median(profile_function(n_trials, segments_intersect_polygons, (segments, polygons, 1)))
+
+        print(f'    {name:>16}{1e9 * point_time / n_queries:>14.1f}{1e9 * segment_time / n_queries:>16.1f}')
+
+
+if __name__ == '__main__':
+    profile_robust_predicates()
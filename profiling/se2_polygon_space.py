@@ -0,0 +1,55 @@
+from typing import Tuple
+
+import numpy as np
+from navitools import Polygon, RandomStream, SE2PolygonSpace, build_prm
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_statistics, pretty_print_title, profile_function
+
+
+FOOTPRINT = Polygon(np.array([[-1., -0.5], [1., -0.5], [1., 0.5], [-1., 0.5]]))
+
+
+def make_transitions(search_space: SE2PolygonSpace, n: int, step: float) -> Tuple[np.ndarray, np.ndarray]:
+    stream = RandomStream(1)
+    starts = search_space.sample_free_space(n, stream)
+    ends = starts + step * (stream.uniform_block(n, 3) - 0.5)
+
+    return starts, ends
+
+
+def profile_se2_polygon_space(obstacle_counts: Tuple[int, ...] = (10, 100, 1_000), steps: Tuple[float, ...] = (1., 4.),
+                              n_queries: int = 5_000, xrange: Tuple[float, float] = (-50, 50),
+                              yrange: Tuple[float, float] = (-50, 50), n_trials: int = 5):
+
+    pretty_print_title(f'Profiling SE2PolygonSpace queries against obstacle count: {n_queries} queries, 2 x 1 footprint')
+    print(f'    {"Obstacles":>10}{"Step":>6}{"State (us)":>14}{"Transition (us)":>18}{"Valid":>8}')
+
+    # Longer steps, and steps closer to obstacles, cover their sweep with more clearance checks
+    for n_obstacles in obstacle_counts:
+        search_space = SE2PolygonSpace(FOOTPRINT, make_random_triangles(n_obstacles, xrange, yrange), xrange, yrange, seed=0)
+
+        for step in steps:
+            starts, ends = make_transitions(search_space, n_queries, step)
+
+            state_time = np.median(profile_function(n_trials, search_space.valid_states, (starts,)))
+            transition_time = np.median(profile_function(n_trials, search_space.valid_transitions, (starts, ends)))
+            valid_share = np.mean(search_space.valid_transitions(starts, ends))
+
+            print(f'    {n_obstacles:>10}{step:>6}{1e6 * state_time / n_queries:>14.3f}'
+                  f'{1e6 * transition_time / n_queries:>18.3f}{valid_share:>8.2f}')
+
+
+def profile_se2_build_prm(n_samples: int = 2_000, n_batch: int = 100, k_neighbors: int = 10, n_obstacles: int = 200,
+                          xrange: Tuple[float, float] = (-25, 25), yrange: Tuple[float, float] = (-25, 25), n_trials: int = 3):
+
+    search_space = SE2PolygonSpace(FOOTPRINT, make_random_triangles(n_obstacles, xrange, yrange), xrange, yrange, seed=0)
+
+    pretty_print_title(f'Profiling build_prm in an SE2PolygonSpace: {n_obstacles} triangles, {n_samples} samples')
+    runtimes = profile_function(n_trials, build_prm, (n_samples, n_batch, k_neighbors, search_space))
+    pretty_print_statistics(runtimes)
+
+
+if __name__ == '__main__':
+    profile_se2_polygon_space()
+    profile_se2_build_prm()
@@ -0,0 +1,61 @@
+import pickle
+from math import ceil
+from typing import Tuple
+
+import numpy as np
+from navitools import PolygonSpace, RandomStream, Roadmap, build_prm, build_sparse_roadmap, dijkstra
+from navitools.testing import make_random_triangles
+
+from reporting import pretty_print_title
+
+
+def n_edges(roadmap: Roadmap) -> int:
+    return sum(len(roadmap.node_at(state).neighbors) for state in roadmap.states) // 2
+
+
+def query_length(roadmap: Roadmap, search_space: PolygonSpace, start: np.ndarray, goal: np.ndarray,
+                 radius: float) -> float:
+    # Connect the query to a copy of the roadmap, so the queries do not add up
+    roadmap = pickle.loads(pickle.dumps(roadmap))
+    states = roadmap.states
+
+    for state in (start, goal):
+        neighbors = np.array([other for other in states
+                              if np.linalg.norm(other - state) <= radius and search_space.valid_transition(state, other)])
+        neighbors = neighbors.reshape(-1, 2)
+        costs = np.array([search_space.transition_cost(state, neighbor) for neighbor in neighbors])
+        roadmap.add_node(state, neighbors, costs)
+
+    path = dijkstra(roadmap, start, goal)
+
+    return np.linalg.norm(np.diff(path, axis=0), axis=1).sum() if path.size else np.inf
+
+
+def profile_sparse_roadmap(stretches: Tuple[float, ...] = (1.2, 1.5, 2., 3., 5.), visibility_radius: float = 3.,
+                           n_dense_samples: int = 30_000, n_batch: int = 50, k_neighbors: int = 15,
+                           min_n_vertices: int = 180, xrange: Tuple[float, float] = (-10, 10),
+                           yrange: Tuple[float, float] = (-10, 10), n_queries: int = 20):
+
+    n_triangles = ceil(min_n_vertices / 3)
+    search_space = PolygonSpace(make_random_triangles(n_triangles, xrange, yrange), xrange, yrange)
+
+    queries = search_space.sample_free_space(2 * n_queries, RandomStream(1))
+
+    def mean_length(roadmap: Roadmap) -> float:
+        return np.mean([query_length(roadmap, search_space, queries[2 * i], queries[2 * i + 1], visibility_radius)
+                        for i in range(n_queries)])
+
+    dense = build_prm(n_dense_samples, n_batch, k_neighbors, search_space, seed=0)
+    dense_length = mean_length(dense)
+
+    pretty_print_title(f'Profiling sparse roadmaps against a {dense.n_states} node PRM: {n_queries} queries')
+    print(f'    {"Stretch":>8}{"Nodes":>8}{"Edges":>8}{"Path length / PRM":>20}')
+    print(f'    {"PRM":>8}{dense.n_states:>8}{n_edges(dense):>8}{1.:>20.3f}')
+
+    for stretch in stretches:
+        sparse = build_sparse_roadmap(search_space, visibility_radius, stretch, seed=0)
+        print(f'    {stretch:>8}{sparse.n_states:>8}{n_edges(sparse):>8}{mean_length(sparse) / dense_length:>20.3f}')
+
+
+if __name__ == '__main__':
+    profile_sparse_roadmap()
@@ -18,6 +18,13 @@ class FooSearchSpace(SearchSpace):
     def transition_cost(self, a: np.ndarray, b: np.ndarray) -> float:
         return np.sqrt(a.dot(b))
 
+    # Vectorized batch forms, so build_prm makes one Python call per batch of edges
+    def valid_transitions(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+        return np.ones(len(a), dtype=bool)
+
+    def transition_costs(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+        return np.sqrt(np.einsum('ij,ij->i', a, b))
+
 
 if __name__ == '__main__':
     from navitools import build_prm
@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include "box_index.hpp"
+
+
+// Boxes tested at once, a few vector registers' worth, before checking for a hit
+const int SLAB_BLOCK = 32;
+
+typedef Eigen::Array<double, Eigen::Dynamic, 1, 0, SLAB_BLOCK, 1> SlabArray;
+
+// Most axes the grid spans, and upper limit on its number of cells
+const int MAX_INDEXED_AXES = 3;
+const int MAX_GRID_CELLS = 1 << 18;
+
+// Per-axis scratch for the queries, kept on the stack
+typedef Eigen::Matrix<double, Eigen::Dynamic, 1, 0, MAX_INDEXED_AXES, 1> AxisVector;
+typedef Eigen::Matrix<int, Eigen::Dynamic, 1, 0, MAX_INDEXED_AXES, 1> AxisCell;
+
+// Boxes and segments are padded by this share of a cell, so rounding never loses a cell
+const double CELL_PADDING = 1e-9;
+
+bool boxes_contain(const BoxSet& boxes, const Eigen::VectorXd& point)
+{
+    for (int start = 0; start < boxes.size(); start += SLAB_BLOCK) {
+        int m = std::min(SLAB_BLOCK, boxes.size() - start);
+
+        // How far the point is outside each box along the axis it is furthest outside along
+        SlabArray outside = SlabArray::Constant(m, -INFINITY);
+        for (int j = 0; j < point.size(); j++) {
+            SlabArray below = boxes.lower.col(j).segment(start, m).array() - point(j);
+            SlabArray above = point(j) - boxes.upper.col(j).segment(start, m).array();
+            outside = outside.max(below.max(above));
+        }
+
+        if ((outside <= 0.).any())
+            return true;
+    }
+
+    return false;
+}
+
+bool segment_touches_boxes(const BoxSet& boxes, const Eigen::VectorXd& a, const Eigen::VectorXd& inverse)
+{
+    for (int start = 0; start < boxes.size(); start += SLAB_BLOCK) {
+        int m = std::min(SLAB_BLOCK, boxes.size() - start);
+
+        // Part of the segment inside every slab so far
+        SlabArray t_near = SlabArray::Zero(m), t_far = SlabArray::Ones(m);
+        for (int j = 0; j < a.size(); j++) {
+            SlabArray below = boxes.lower.col(j).segment(start, m).array() - a(j);
+            SlabArray above = boxes.upper.col(j).segment(start, m).array() - a(j);
+
+            // A segment that does not move along the axis is inside the slab all along or never, even from one of its faces
+            if (std::isinf(inverse(j))) {
+                t_far = (below <= 0. && above >= 0.).select(t_far, -1.);
+                continue;
+            }
+
+            SlabArray t_lower = below * inverse(j), t_upper = above * inverse(j);
+            t_near = t_near.max(t_lower.min(t_upper));
+            t_far = t_far.min(t_lower.max(t_upper));
+        }
+
+        if ((t_near <= t_far).any())
+            return true;
+    }
+
+    return false;
+}
+
+Eigen::VectorXd segment_inverse(const Eigen::VectorXd& a, const Eigen::VectorXd& b)
+{
+    Eigen::VectorXd inverse(a.size());
+    for (int j = 0; j < a.size(); j++)
+        inverse(j) = 1. / (b(j) - a(j));
+
+    return inverse;
+}
+
+BoxIndex::BoxIndex(const BoxSet& boxes)
+{
+    int n = boxes.size(), d = boxes.lower.cols();
+    if (n == 0 || d == 0)
+        return;
+
+    Eigen::VectorXd lower = boxes.lower.colwise().minCoeff(), upper = boxes.upper.colwise().maxCoeff();
+    Eigen::VectorXd extent = (upper - lower).cwiseMax(1e-12);
+    Eigen::VectorXd mean_width = (boxes.upper - boxes.lower).colwise().mean();
+
+    // Share of each axis the typical box covers, the smaller the better the axis splits the boxes
+    Eigen::VectorXd share = mean_width.cwiseQuotient(extent);
+
+    _axes.resize(d);
+    std::iota(_axes.begin(), _axes.end(), 0);
+    std::stable_sort(_axes.begin(), _axes.end(), [&](int i, int j) {return share(i) < share(j);});
+    _axes.resize(std::min(d, MAX_INDEXED_AXES));
+
+    int k = _axes.size();
+
+    // About one box per cell, but no cells narrower than the typical box so each sits in few cells
+    int per_axis = std::max((int)std::ceil(std::pow(n, 1. / k)), 1);
+    per_axis = std::min(per_axis, (int)std::pow(MAX_GRID_CELLS, 1. / k));
+
+    _origin.resize(k);
+    _cell_size.resize(k);
+    _counts.resize(k);
+    _strides.resize(k);
+
+    int n_cells = 1;
+    for (int q = 0; q < k; q++) {
+        int axis = _axes[q];
+        int widest = (int)std::min(std::ceil(extent(axis) / std::max(mean_width(axis), 1e-12)), (double)per_axis);
+
+        _counts(q) = std::max(widest, 1);
+        _cell_size(q) = extent(axis) / _counts(q);
+        _origin(q) = lower(axis);
+        _strides(q) = n_cells;
+        n_cells *= _counts(q);
+    }
+
+    std::vector<std::vector<int>> members(n_cells);
+    AxisCell first(k), last(k), cell(k);
+
+    for (int i = 0; i < n; i++) {
+        for (int q = 0; q < k; q++) {
+            double padding = CELL_PADDING * _cell_size(q);
+            first(q) = index(q, boxes.lower(i, _axes[q]) - padding);
+            last(q) = index(q, boxes.upper(i, _axes[q]) + padding);
+        }
+
+        // Every cell in the range, counting through the axes like an odometer
+        cell = first;
+        while (true) {
+            members[cell.dot(_strides)].push_back(i);
+
+            int q = 0;
+            while (q < k && cell(q) == last(q)) {
+                cell(q) = first(q);
+                q++;
+            }
+            if (q == k)
+                break;
+            cell(q)++;
+        }
+    }
+
+    _cells.resize(n_cells);
+    for (int c = 0; c < n_cells; c++) {
+        _cells[c].lower.resize(members[c].size(), d);
+        _cells[c].upper.resize(members[c].size(), d);
+
+        for (int r = 0; r < _cells[c].lower.rows(); r++) {
+            _cells[c].lower.row(r) = boxes.lower.row(members[c][r]);
+            _cells[c].upper.row(r) = boxes.upper.row(members[c][r]);
+        }
+    }
+}
+
+int BoxIndex::index(int q, double value) const
+{
+    double i = std::floor((value - _origin(q)) / _cell_size(q));
+    return (int)std::min(std::max(i, 0.), (double)(_counts(q) - 1));
+}
+
+int BoxIndex::cell_at(const Eigen::VectorXd& point) const
+{
+    if (_cells.empty())
+        return -1;
+
+    int cell = 0;
+    for (int q = 0; q < (int)_axes.size(); q++) {
+        double value = point(_axes[q]);
+
+        // NaNs are not inside anything either
+        if (!(value >= _origin(q) && value <= _origin(q) + _counts(q) * _cell_size(q)))
+            return -1;
+
+        cell += index(q, value) * _strides(q);
+    }
+
+    return cell;
+}
+
+std::vector<int> BoxIndex::cells_along(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    std::vector<int> found;
+    if (_cells.empty())
+        return found;
+
+    int k = _axes.size();
+
+    // The segment along the indexed axes, measured in cells from the origin
+    AxisVector from(k), to(k);
+    for (int q = 0; q < k; q++) {
+        from(q) = (a(_axes[q]) - _origin(q)) / _cell_size(q);
+        to(q) = (b(_axes[q]) - _origin(q)) / _cell_size(q);
+    }
+
+    /*  Walk the cells along the axis the segment crosses the most cells of, and in each slice take
+        the cells the segment spans along the other axes. Keeping the slopes at most 1 keeps the
+        rounding of the spans well inside the padding.
+    */
+    int major;
+    (to - from).cwiseAbs().maxCoeff(&major);
+    if (from(major) > to(major))
+        std::swap(from, to);
+
+    double length = to(major) - from(major);
+    auto cell_of = [&](int q, double value) {
+        return (int)std::min(std::max(std::floor(value), 0.), (double)(_counts(q) - 1));
+    };
+
+    AxisCell first(k), last(k), cell(k);
+
+    int i0 = cell_of(major, from(major) - CELL_PADDING), i1 = cell_of(major, to(major) + CELL_PADDING);
+    for (int i = i0; i <= i1; i++) {
+        // Slices at the edges of the grid reach out to the segment's ends beyond it
+        double s0 = i == 0 ? from(major) : std::max(from(major), (double)i);
+        double s1 = i == _counts(major) - 1 ? to(major) : std::min(to(major), i + 1.);
+
+        for (int q = 0; q < k; q++) {
+            if (q == major) {
+                first(q) = last(q) = i;
+                continue;
+            }
+
+            double slope = length > 0. ? (to(q) - from(q)) / length : 0.;
+            double v0 = from(q) + slope * (s0 - from(major)), v1 = from(q) + slope * (s1 - from(major));
+
+            first(q) = cell_of(q, std::min(v0, v1) - CELL_PADDING);
+            last(q) = cell_of(q, std::max(v0, v1) + CELL_PADDING);
+        }
+
+        cell = first;
+        while (true) {
+            found.push_back(cell.dot(_strides));
+
+            int q = 0;
+            while (q < k && cell(q) == last(q)) {
+                cell(q) = first(q);
+                q++;
+            }
+            if (q == k)
+                break;
+            cell(q)++;
+        }
+    }
+
+    return found;
+}
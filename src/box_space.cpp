@@ -0,0 +1,93 @@
+#include "box_space.hpp"
+
+
+// Fewest boxes worth building the grid index for, below which testing every box is as fast
+const int MIN_INDEXED_BOXES = 64;
+
+BoxSpace::BoxSpace(const Eigen::MatrixXd& box_lower, const Eigen::MatrixXd& box_upper, const Eigen::VectorXd& lower,
+    const Eigen::VectorXd& upper, long seed)
+{
+    if (lower.size() != upper.size())
+        throw BadStateSizeException{"The lower and upper corners of the space do not have the same size"};
+
+    if (box_lower.rows() != box_upper.rows() || box_lower.cols() != lower.size() || box_upper.cols() != lower.size()
+        || (box_lower.array() > box_upper.array()).any())
+        throw BadBoxException{};
+
+    _boxes.lower = box_lower;
+    _boxes.upper = box_upper;
+
+    if (_boxes.size() >= MIN_INDEXED_BOXES)
+        _index = BoxIndex{_boxes};
+
+    _lower = lower;
+    _upper = upper;
+
+    set_seed(seed);
+
+    set_state_size(lower.size());
+}
+
+Eigen::MatrixXd BoxSpace::sample_free_space(int n) const
+{
+    RandomStream stream = next_stream();
+    return sample_free_space(n, stream);
+}
+
+Eigen::MatrixXd BoxSpace::sample_free_space(int n, RandomStream& stream) const
+{
+    return sample_rejecting(n, _lower, _upper, stream, [this](const Eigen::VectorXd& sample) {
+        return inside_obstacle(sample);
+    });
+}
+
+Eigen::MatrixXd BoxSpace::sample_space(int n, RandomStream& stream) const
+{
+    Eigen::MatrixXd samples(n, _lower.size());
+    draw_candidates(samples, _lower, _upper, stream);
+
+    return samples;
+}
+
+bool BoxSpace::valid_state(const Eigen::VectorXd& state) const
+{
+    // Written so that NaNs are out of bounds
+    if (!((state.array() >= _lower.array()).all() && (state.array() <= _upper.array()).all()))
+        return false;
+
+    return !inside_obstacle(state);
+}
+
+bool BoxSpace::valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    // The space is a box, so a transition between two states inside it stays inside it
+    if (!valid_state(a) || !valid_state(b))
+        return false;
+
+    Eigen::VectorXd inverse = segment_inverse(a, b);
+
+    if (_index.empty())
+        return !segment_touches_boxes(_boxes, a, inverse);
+
+    for (int cell : _index.cells_along(a, b)) {
+        if (segment_touches_boxes(_index.cell(cell), a, inverse))
+            return false;
+    }
+
+    return true;
+}
+
+double BoxSpace::transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    Eigen::VectorXd ab = b - a;
+    return ab.dot(ab);
+}
+
+bool BoxSpace::inside_obstacle(const Eigen::VectorXd& point) const
+{
+    if (_index.empty())
+        return boxes_contain(_boxes, point);
+
+    int cell = _index.cell_at(point);
+    return cell >= 0 && boxes_contain(_index.cell(cell), point);
+}
@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <unordered_map>
+#include "contraction_hierarchy.hpp"
+
+
+typedef std::pair<double, int> CostIndexPair;
+typedef std::priority_queue<CostIndexPair, std::vector<CostIndexPair>, std::greater<CostIndexPair>> MinCostIndexQueue;
+
+// Witness searches give up after settling this many nodes and assume no witness exists, which can
+// only add unnecessary shortcuts, never lose a shortest path. Simulated contractions, which only
+// estimate the priority of a node, use a tighter limit.
+const int WITNESS_SETTLE_LIMIT = 50;
+const int SIMULATION_SETTLE_LIMIT = 15;
+
+/* Contraction state, only needed while the hierarchy is built */
+
+struct Contraction {
+    std::vector<std::vector<HierarchyEdge>> adjacency;  // Edges between nodes not contracted yet
+    std::vector<int> n_contracted_neighbors;
+    std::vector<int> level;     // Depth of the hierarchy below each node
+
+    // Scratch space for the witness searches
+    std::vector<double> dist;
+    std::vector<int> touched;
+    std::vector<bool> is_target;
+    std::vector<CostIndexPair> heap;
+
+    Contraction(const RoadmapGraph& graph) : adjacency(graph.n_nodes()), n_contracted_neighbors(graph.n_nodes(), 0),
+        level(graph.n_nodes(), 0), dist(graph.n_nodes(), INFINITY), is_target(graph.n_nodes(), false)
+    {
+        const std::vector<int>& offsets = graph.offsets();
+        const std::vector<int>& targets = graph.targets();
+        const std::vector<double>& costs = graph.costs();
+
+        for (int u = 0; u < graph.n_nodes(); u++) {
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                if (targets[e] != u)
+                    add_edge(u, targets[e], costs[e], -1);
+            }
+        }
+    }
+
+    // Inserts or shortens the edge from u to w, keeping one edge per pair of nodes
+    void add_edge(int u, int w, double cost, int middle)
+    {
+        for (HierarchyEdge& edge : adjacency[u]) {
+            if (edge.target == w) {
+                if (cost < edge.cost) {
+                    edge.cost = cost;
+                    edge.middle = middle;
+                }
+                return;
+            }
+        }
+
+        adjacency[u].push_back({w, cost, middle});
+    }
+
+    // Bounded Dijkstra search from the source that avoids the node being contracted, stopping early
+    // once every target has been settled
+    void witness_search(int source, int avoid, double max_cost, int n_targets, int settle_limit)
+    {
+        for (int v : touched)
+            dist[v] = INFINITY;
+        touched.clear();
+
+        dist[source] = 0.;
+        touched.push_back(source);
+
+        // Heap storage is reused between searches to avoid reallocating it
+        heap.clear();
+        heap.push_back({0., source});
+
+        int n_settled = 0;
+        while (!heap.empty() && n_settled < settle_limit && n_targets > 0) {
+            std::pop_heap(heap.begin(), heap.end(), std::greater<CostIndexPair>());
+            CostIndexPair current = heap.back();
+            heap.pop_back();
+
+            int u = current.second;
+            if (current.first > dist[u])
+                continue;
+            if (current.first > max_cost)
+                break;
+
+            n_settled++;
+            if (is_target[u])
+                n_targets--;
+
+            for (const HierarchyEdge& edge : adjacency[u]) {
+                if (edge.target == avoid)
+                    continue;
+
+                double new_cost = current.first + edge.cost;
+                if (new_cost < dist[edge.target]) {
+                    if (std::isinf(dist[edge.target]))
+                        touched.push_back(edge.target);
+
+                    dist[edge.target] = new_cost;
+                    heap.push_back({new_cost, edge.target});
+                    std::push_heap(heap.begin(), heap.end(), std::greater<CostIndexPair>());
+                }
+            }
+        }
+    }
+
+    // Finds the shortcuts needed to contract v, and adds them unless this is a simulation
+    int contract(int v, bool simulate)
+    {
+        // Copied since the shortcuts change the adjacency lists
+        const std::vector<HierarchyEdge> neighbors = adjacency[v];
+        int n_neighbors = neighbors.size();
+        int settle_limit = simulate ? SIMULATION_SETTLE_LIMIT : WITNESS_SETTLE_LIMIT;
+
+        int n_shortcuts = 0;
+        for (int i = 0; i < n_neighbors; i++) {
+            const HierarchyEdge& in = neighbors[i];
+
+            // Only the pairs with the later neighbors are checked from here
+            double max_out = 0.;
+            for (int j = i + 1; j < n_neighbors; j++) {
+                max_out = std::max(max_out, neighbors[j].cost);
+                is_target[neighbors[j].target] = true;
+            }
+
+            witness_search(in.target, v, in.cost + max_out, n_neighbors - i - 1, settle_limit);
+
+            for (int j = i + 1; j < n_neighbors; j++)
+                is_target[neighbors[j].target] = false;
+
+            for (int j = i + 1; j < n_neighbors; j++) {
+                const HierarchyEdge& out = neighbors[j];
+                double via_cost = in.cost + out.cost;
+
+                if (dist[out.target] <= via_cost)
+                    continue;   // Found a witness path that is no longer than going through v
+
+                n_shortcuts++;
+
+                if (!simulate) {
+                    add_edge(in.target, out.target, via_cost, v);
+                    add_edge(out.target, in.target, via_cost, v);
+                }
+            }
+        }
+
+        return n_shortcuts;
+    }
+
+    // Edge difference, plus terms that spread the contractions uniformly over the graph and keep the
+    // hierarchy shallow
+    int priority(int v)
+    {
+        return contract(v, true) - (int)adjacency[v].size() + n_contracted_neighbors[v] + level[v];
+    }
+};
+
+ContractionHierarchy::ContractionHierarchy(const Roadmap& roadmap) : _graph(roadmap.get_graph())
+{
+    int n_nodes = _graph.n_nodes();
+
+    _rank.assign(n_nodes, -1);
+    _upward.resize(n_nodes);
+
+    Contraction contraction{_graph};
+
+    typedef std::pair<int, int> PriorityIndexPair;
+    std::priority_queue<PriorityIndexPair, std::vector<PriorityIndexPair>, std::greater<PriorityIndexPair>> order;
+
+    for (int v = 0; v < n_nodes; v++)
+        order.push({contraction.priority(v), v});
+
+    int rank = 0;
+    while (!order.empty()) {
+        int v = order.top().second;
+        order.pop();
+
+        // Priorities go stale as the neighborhood is contracted, so refresh lazily and put the node
+        // back if it is no longer the cheapest to contract
+        int priority = contraction.priority(v);
+        if (!order.empty() && priority > order.top().first) {
+            order.push({priority, v});
+            continue;
+        }
+
+        // Every remaining edge of v leads to a node that will be ranked higher
+        _upward[v] = contraction.adjacency[v];
+
+        contraction.contract(v, false);
+
+        for (const HierarchyEdge& edge : contraction.adjacency[v]) {
+            std::vector<HierarchyEdge>& neighbor_edges = contraction.adjacency[edge.target];
+            neighbor_edges.erase(std::remove_if(neighbor_edges.begin(), neighbor_edges.end(),
+                [v](const HierarchyEdge& e) { return e.target == v; }), neighbor_edges.end());
+
+            contraction.n_contracted_neighbors[edge.target]++;
+            contraction.level[edge.target] = std::max(contraction.level[edge.target], contraction.level[v] + 1);
+        }
+
+        contraction.adjacency[v].clear();
+        contraction.adjacency[v].shrink_to_fit();
+
+        _rank[v] = rank++;
+    }
+
+    for (int v = 0; v < n_nodes; v++) {
+        for (const HierarchyEdge& edge : _upward[v]) {
+            if (edge.middle >= 0)
+                _n_shortcuts++;
+        }
+    }
+}
+
+int ContractionHierarchy::middle_of(int u, int w) const
+{
+    int lower = _rank[u] < _rank[w] ? u : w;
+    int upper = lower == u ? w : u;
+
+    for (const HierarchyEdge& edge : _upward[lower]) {
+        if (edge.target == upper)
+            return edge.middle;
+    }
+
+    return -1;
+}
+
+// Appends the roadmap nodes along the edge from u to w, excluding u itself
+void ContractionHierarchy::unpack_edge(int u, int w, std::vector<int>& path) const
+{
+    int middle = middle_of(u, w);
+
+    if (middle < 0) {
+        path.push_back(w);
+        return;
+    }
+
+    unpack_edge(u, middle, path);
+    unpack_edge(middle, w, path);
+}
+
+Eigen::MatrixXd ContractionHierarchy::query(const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state) const
+{
+    SearchStatistics statistics;
+
+    return query(start_state, goal_state, statistics);
+}
+
+Eigen::MatrixXd ContractionHierarchy::query(const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics) const
+{
+    statistics = SearchStatistics{};
+
+    int start = _graph.index_of(start_state);
+    int goal = _graph.index_of(goal_state);
+
+    // Cost and parent for each node reached, per direction. The search spaces are tiny compared to
+    // the roadmap, so hash maps beat clearing dense arrays on every query.
+    std::unordered_map<int, std::pair<double, int>> reached[2];
+    MinCostIndexQueue queues[2];
+
+    reached[0][start] = {0., -1};
+    reached[1][goal] = {0., -1};
+    queues[0].push({0., start});
+    queues[1].push({0., goal});
+
+    double best_cost = INFINITY;
+    int meeting_node = -1;
+
+    while (!queues[0].empty() || !queues[1].empty()) {
+        for (int side = 0; side < 2; side++) {
+            MinCostIndexQueue& queue = queues[side];
+
+            if (queue.empty())
+                continue;
+
+            if (queue.top().first >= best_cost) {
+                // Nothing left in this direction can improve the meeting point
+                queue = MinCostIndexQueue{};
+                continue;
+            }
+
+            CostIndexPair current = queue.top();
+            queue.pop();
+
+            int u = current.second;
+            if (current.first > reached[side][u].first)
+                continue;
+
+            statistics.n_expansions++;
+
+            auto other = reached[1 - side].find(u);
+            if (other != reached[1 - side].end() && current.first + other->second.first < best_cost) {
+                best_cost = current.first + other->second.first;
+                meeting_node = u;
+            }
+
+            for (const HierarchyEdge& edge : _upward[u]) {
+                double new_cost = current.first + edge.cost;
+
+                auto it = reached[side].find(edge.target);
+                if (it == reached[side].end() || new_cost < it->second.first) {
+                    reached[side][edge.target] = {new_cost, u};
+                    queue.push({new_cost, edge.target});
+                }
+            }
+        }
+    }
+
+    if (meeting_node < 0)
+        return {};
+
+    // Walk the parents of both searches back from the meeting node to get the hierarchy path
+    std::vector<int> hierarchy_path;
+    for (int v = meeting_node; v != -1; v = reached[0][v].second)
+        hierarchy_path.push_back(v);
+    std::reverse(hierarchy_path.begin(), hierarchy_path.end());
+
+    for (int v = reached[1][meeting_node].second; v != -1; v = reached[1][v].second)
+        hierarchy_path.push_back(v);
+
+    std::vector<int> path = {hierarchy_path[0]};
+    for (int i = 0; i + 1 < (int)hierarchy_path.size(); i++)
+        unpack_edge(hierarchy_path[i], hierarchy_path[i + 1], path);
+
+    return _graph.path_states(path);
+}
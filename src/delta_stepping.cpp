@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include "parallel.hpp"
+#include "search_roadmap.hpp"
+
+
+/* Relaxation request for the cost of reaching a node */
+
+struct Relaxation {
+    int node;
+    double cost;
+};
+
+/*  Picks delta from the edge cost distribution
+
+    Following Meyer and Sanders, the bucket width scales like the typical edge cost over the typical
+    degree, which bounds how often a node is relaxed again inside its bucket. The factor of four was
+    the fastest on PRM roadmaps, whose costs are squared distances between k nearest neighbors.
+*/
+double tune_delta(const RoadmapGraph& graph)
+{
+    const std::vector<double>& costs = graph.costs();
+
+    // Invalid edges of lazy roadmaps have infinite costs and are left out
+    double total = 0.;
+    int n_finite = 0;
+    for (double cost : costs) {
+        if (std::isfinite(cost)) {
+            total += cost;
+            n_finite++;
+        }
+    }
+
+    if (!n_finite || total <= 0.)
+        return 1.;
+
+    double mean_cost = total / n_finite;
+    double mean_degree = (double)graph.n_edges() / graph.n_nodes();
+
+    return 4. * mean_cost / std::max(mean_degree, 1.);
+}
+
+std::vector<double> delta_stepping_costs(const RoadmapGraph& graph, int source, double delta, int n_threads)
+{
+    const std::vector<int>& offsets = graph.offsets();
+    const std::vector<int>& targets = graph.targets();
+    const std::vector<double>& costs = graph.costs();
+
+    int n_nodes = graph.n_nodes();
+
+    if (std::isnan(delta))
+        throw BadParameterException{"delta has to be a number"};
+    if (delta <= 0.)
+        delta = tune_delta(graph);
+
+    ThreadTeam team{n_threads};
+    int n_teammates = team.size();
+
+    std::vector<double> cost_so_far(n_nodes, INFINITY);
+    cost_so_far[source] = 0.;
+
+    /*  Only the buckets in use are kept, by index, since a delta much smaller than the edge costs
+        spreads the nodes over far more buckets than there are nodes. The indices are doubles so
+        that they cannot overflow, and merge buckets at worst, which the loop below allows for.
+    */
+    std::map<double, std::vector<int>> buckets = {{0., {source}}};
+
+    // Each node is owned by one thread, which is the only one that writes its cost. Requests are
+    // sorted by owner as they are generated: requests[generator][owner].
+    std::vector<std::vector<std::vector<Relaxation>>> requests(n_teammates, std::vector<std::vector<Relaxation>>(n_teammates));
+    std::vector<std::vector<int>> improved(n_teammates);
+
+    auto bucket_of = [delta](double cost) { return std::floor(cost / delta); };
+
+    auto relax_edges = [&](const std::vector<int>& nodes, bool light) {
+        team.run([&](int t) {
+            for (std::vector<Relaxation>& owner_requests : requests[t])
+                owner_requests.clear();
+
+            size_t begin = nodes.size() * t / n_teammates;
+            size_t end = nodes.size() * (t + 1) / n_teammates;
+
+            for (size_t i = begin; i < end; i++) {
+                int u = nodes[i];
+
+                for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                    if ((costs[e] <= delta) == light)
+                        requests[t][targets[e] % n_teammates].push_back({targets[e], cost_so_far[u] + costs[e]});
+                }
+            }
+        });
+
+        team.run([&](int t) {
+            improved[t].clear();
+
+            for (int generator = 0; generator < n_teammates; generator++) {
+                for (const Relaxation& request : requests[generator][t]) {
+                    if (request.cost < cost_so_far[request.node]) {
+                        cost_so_far[request.node] = request.cost;
+                        improved[t].push_back(request.node);
+                    }
+                }
+            }
+        });
+
+        for (const std::vector<int>& nodes : improved) {
+            for (int v : nodes)
+                buckets[bucket_of(cost_so_far[v])].push_back(v);
+        }
+    };
+
+    // Stamps to drop duplicate and stale bucket entries without clearing arrays every phase
+    std::vector<long> frontier_stamp(n_nodes, -1);
+    std::vector<long> settled_stamp(n_nodes, -1);
+    long phase = 0;
+
+    for (long round = 0; !buckets.empty(); round++) {
+        // Inserting into the map leaves the iterator valid
+        auto bucket = buckets.begin();
+        double i = bucket->first;
+
+        std::vector<int> settled;
+
+        // Light edges can put nodes back into the current bucket, so keep going until it stays empty
+        while (!bucket->second.empty()) {
+            std::vector<int> entries;
+            std::swap(entries, bucket->second);
+
+            std::vector<int> frontier;
+            for (int v : entries) {
+                if (frontier_stamp[v] == phase || bucket_of(cost_so_far[v]) != i)
+                    continue;
+
+                frontier_stamp[v] = phase;
+                frontier.push_back(v);
+
+                if (settled_stamp[v] != round) {
+                    settled_stamp[v] = round;
+                    settled.push_back(v);
+                }
+            }
+            phase++;
+
+            relax_edges(frontier, true);
+        }
+
+        // The costs in the bucket are final now, so the heavy edges only need relaxing once
+        relax_edges(settled, false);
+
+        // Heavy edges only land back in the bucket if rounding merged buckets, and then it goes round again
+        if (bucket->second.empty())
+            buckets.erase(bucket);
+    }
+
+    return cost_so_far;
+}
+
+Eigen::VectorXd delta_stepping(const Roadmap& roadmap, const Eigen::VectorXd& source_state, int n_threads, double delta)
+{
+    const RoadmapGraph& graph = roadmap.get_graph();
+
+    std::vector<double> costs = delta_stepping_costs(graph, graph.index_of(source_state), delta, n_threads);
+
+    return Eigen::Map<Eigen::VectorXd>(costs.data(), costs.size());
+}
+
+Eigen::VectorXd dijkstra_costs(const Roadmap& roadmap, const Eigen::VectorXd& source_state)
+{
+    const RoadmapGraph& graph = roadmap.get_graph();
+
+    std::vector<double> costs = shortest_path_costs(graph, graph.index_of(source_state));
+
+    return Eigen::Map<Eigen::VectorXd>(costs.data(), costs.size());
+}
@@ -0,0 +1,102 @@
+#include <algorithm>
+#include <cmath>
+#include "free_space_raster.hpp"
+
+
+enum class CellOccupancy {free, mixed, blocked};
+
+CellOccupancy cell_occupancy(const Eigen::Vector2d& lower, const Eigen::Vector2d& upper, const Polygon& polygon)
+{
+    if ((polygon.bounds_max().array() < lower.array()).any() || (polygon.bounds_min().array() > upper.array()).any())
+        return polygon.is_hollow() ? CellOccupancy::blocked : CellOccupancy::free;
+
+    // The polygon's boundary is in the cell if it crosses one of the cell's sides or lies wholly inside it
+    Eigen::Vector2d vertex = polygon[0];
+    if ((vertex.array() >= lower.array()).all() && (vertex.array() <= upper.array()).all())
+        return CellOccupancy::mixed;
+
+    Eigen::Vector2d corners[4] = {lower, {upper.x(), lower.y()}, upper, {lower.x(), upper.y()}};
+    for (int i = 0; i < 4; i++) {
+        int code = segment_intersects_polygon({corners[i], corners[(i + 1) % 4]}, polygon);
+        if (code == 1 || code == 2)
+            return CellOccupancy::mixed;
+    }
+
+    // Otherwise the whole cell is on one side of the boundary
+    return inside_polygon((lower + upper) / 2., polygon) ? CellOccupancy::blocked : CellOccupancy::free;
+}
+
+FreeSpaceRaster::FreeSpaceRaster(const std::vector<Polygon>& polygons, const PolygonIndex& index,
+    std::pair<double, double> xrange, std::pair<double, double> yrange, int resolution)
+{
+    double cell_size = std::max(xrange.second - xrange.first, yrange.second - yrange.first) / std::max(resolution, 1);
+    int nx = std::max((int)std::ceil((xrange.second - xrange.first) / cell_size), 1);
+    int ny = std::max((int)std::ceil((yrange.second - yrange.first) / cell_size), 1);
+
+    double total_area = 0.;
+    auto add_rectangle = [&](const Eigen::Vector2d& lower, const Eigen::Vector2d& upper, bool mixed) {
+        _rectangles.push_back({lower, upper, mixed});
+
+        total_area += (upper - lower).prod();
+        _cumulative_areas.push_back(total_area);
+    };
+
+    for (int iy = 0; iy < ny; iy++) {
+        double y0 = yrange.first + iy * cell_size;
+        double y1 = std::min(y0 + cell_size, yrange.second);
+
+        // Start of the run of free cells that the row is in, if it is in one
+        int run_start = -1;
+
+        for (int ix = 0; ix <= nx; ix++) {
+            CellOccupancy occupancy = CellOccupancy::blocked;
+            Eigen::Vector2d lower, upper;
+
+            if (ix < nx) {
+                lower = {xrange.first + ix * cell_size, y0};
+                upper = {std::min(lower.x() + cell_size, xrange.second), y1};
+
+                occupancy = CellOccupancy::free;
+                for (const std::vector<int>& candidates : {index.within(lower, upper), index.unbounded()}) {
+                    for (int i : candidates) {
+                        CellOccupancy polygon_occupancy = cell_occupancy(lower, upper, polygons[i]);
+                        if (polygon_occupancy != CellOccupancy::free)
+                            occupancy = std::max(occupancy, polygon_occupancy);
+                    }
+                }
+
+                if (occupancy == CellOccupancy::free) {
+                    _n_free++;
+                    if (run_start < 0)
+                        run_start = ix;
+                    continue;
+                }
+
+                occupancy == CellOccupancy::mixed ? _n_mixed++ : _n_blocked++;
+            }
+
+            // The run of free cells ends here
+            if (run_start >= 0) {
+                add_rectangle({xrange.first + run_start * cell_size, y0}, {std::min(xrange.first + ix * cell_size, xrange.second), y1}, false);
+                run_start = -1;
+            }
+
+            if (occupancy == CellOccupancy::mixed)
+                add_rectangle(lower, upper, true);
+        }
+    }
+}
+
+Eigen::Vector2d FreeSpaceRaster::draw(RandomStream& stream, bool& mixed) const
+{
+    double area = stream.uniform() * _cumulative_areas.back();
+    int k = std::upper_bound(_cumulative_areas.begin(), _cumulative_areas.end(), area) - _cumulative_areas.begin();
+    const Rectangle& rectangle = _rectangles[std::min(k, (int)_rectangles.size() - 1)];
+
+    mixed = rectangle.mixed;
+
+    double x = stream.uniform(rectangle.lower.x(), rectangle.upper.x());
+    double y = stream.uniform(rectangle.lower.y(), rectangle.upper.y());
+
+    return {x, y};
+}
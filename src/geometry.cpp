@@ -1,7 +1,9 @@
 #include "geometry.hpp"
+#include "predicates.hpp"
 #include <cmath>
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <algorithm>
 #include <numeric>
 
 
@@ -13,10 +15,12 @@
         >0 if p2 is left of line through p0 and p1
         =0 if p2 is on the line
         <0 if p2 is right of the line
+
+    The sign is exact, see orient2d.
 */
 double is_left(const Eigen::Vector2d& p0, const Eigen::Vector2d& p1, const Eigen::Vector2d& p2)
 {
-    return (p1.x() - p0.x()) * (p2.y() - p0.y()) - (p2.x() - p0.x()) * (p1.y() - p0.y());
+    return orient2d(p0, p1, p2);
 }
 
 /*  Tests the orientation of a triangle
@@ -32,10 +36,10 @@ int triangle_orientation(const Eigen::Vector2d& p0, const Eigen::Vector2d& p1, c
 {
     double val = is_left(p0, p1, p2);
     
-    if (val < -std::numeric_limits<double>::epsilon())
+    if (val < 0.)
         return -1;
 
-    if (val > -std::numeric_limits<double>::epsilon())
+    if (val > 0.)
         return 1;
     
     return 0;
@@ -52,7 +56,7 @@ int triangle_orientation(const Eigen::Vector2d& p0, const Eigen::Vector2d& p1, c
 */
 int polygon_orientation(const Eigen::MatrixX2d& points)
 {
-    double rmin = 0;
+    int rmin = 0;
     double xmin = points.row(0).x();
     double ymin = points.row(0).y();
 
@@ -69,10 +73,54 @@ int polygon_orientation(const Eigen::MatrixX2d& points)
         ymin = points.row(i).y();
     }
 
-    if (rmin == 0)
-        return triangle_orientation(points.row(points.rows() - 1), points.row(0), points.row(1));
-    
-    return triangle_orientation(points.row(rmin - 1), points.row(rmin), points.row(rmin + 1));
+    // The lowest vertex is on the convex hull, so the turn there has the orientation of the polygon
+    int n = points.rows();
+    return triangle_orientation(points.row((rmin + n - 1) % n), points.row(rmin), points.row((rmin + 1) % n));
+}
+
+/*  Tests if a polygon is strictly convex
+
+    Every turn has to be the same way, with no three consecutive vertices on a line, and the
+    vertices can change direction along each axis only twice, which rules out polygons that wind
+    around more than once (e.g. a pentagram).
+*/
+bool polygon_convex(const Eigen::MatrixX2d& points)
+{
+    int n = points.rows();
+    int turn = 0;
+
+    for (int k = 0; k < n; k++) {
+        int orientation = triangle_orientation(points.row(k), points.row((k + 1) % n), points.row((k + 2) % n));
+        if (orientation == 0 || (turn != 0 && orientation != turn))
+            return false;
+
+        turn = orientation;
+    }
+
+    for (int axis = 0; axis < 2; axis++) {
+        // Changes of direction around the whole loop, starting from the direction of the last move
+        int direction = 0;
+        for (int k = 0; k < n && direction == 0; k++) {
+            double step = points((n - k) % n, axis) - points(n - k - 1, axis);
+            direction = (step > 0.) - (step < 0.);
+        }
+
+        int flips = 0;
+        for (int k = 0; k < n; k++) {
+            double step = points((k + 1) % n, axis) - points(k, axis);
+            int next = (step > 0.) - (step < 0.);
+
+            if (next != 0 && next != direction) {
+                flips++;
+                direction = next;
+            }
+        }
+
+        if (flips > 2)
+            return false;
+    }
+
+    return true;
 }
 
 Polygon::Polygon(Eigen::MatrixX2d points)
@@ -86,21 +134,105 @@ Polygon::Polygon(Eigen::MatrixX2d points)
         throw(2);   // Invalid polygon
 
     _points = points;
+    _convex = polygon_convex(points);
+
+    int n_padded = (_n_points + FACET_BLOCK_SIZE - 1) / FACET_BLOCK_SIZE * FACET_BLOCK_SIZE;
+    _xs.resize(n_padded);
+    _ys.resize(n_padded);
+    _dxs.resize(n_padded);
+    _dys.resize(n_padded);
+
+    for (int k = 0; k < n_padded; k++) {
+        int i = std::min(k, _n_points - 1);
+        int j = (i + 1) % _n_points;
+
+        _xs(k) = points(i, 0);
+        _ys(k) = points(i, 1);
+        _dxs(k) = points(j, 0) - points(i, 0);
+        _dys(k) = points(j, 1) - points(i, 1);
+    }
+
+    _min = points.colwise().minCoeff();
+    _max = points.colwise().maxCoeff();
+}
+
+// Fewest vertices for which the binary search of convex polygons beats the winding number loop
+const int MIN_BINARY_SEARCH_POINTS = 10;
+
+/*  Which side of a convex polygon's boundary a point is on, by binary search over the fan of
+    triangles around vertex 0
+
+    Returns:
+        1 if the point is strictly inside the boundary
+        -1 if the point is strictly outside the boundary
+        0 if the point is on the boundary or on a diagonal of the fan, which the caller has to settle
+*/
+int convex_side(const Eigen::Vector2d& point, const Polygon& polygon)
+{
+    const Eigen::ArrayXd& xs = polygon.xs();
+    const Eigen::ArrayXd& ys = polygon.ys();
+    int n = polygon.n_points();
+
+    // >0 if the point is left of the line from vertex i to vertex j, as if the polygon were counter-clockwise
+    auto turn = [&](int i, int j) {
+        return polygon.orientation() * orient2d({xs(i), ys(i)}, {xs(j), ys(j)}, point);
+    };
+
+    double first = turn(0, 1);
+    double last = turn(0, n - 1);
+
+    if (first < 0. || last > 0.)
+        return -1;
+    if (first == 0. || last == 0.)
+        return 0;
+
+    // The point is between the first and the last facet, so find the triangle of the fan it is in
+    int low = 1, high = n - 1;
+    while (high - low > 1) {
+        int mid = (low + high) / 2;
+
+        double side = turn(0, mid);
+        if (side == 0.)
+            return 0;
+
+        if (side > 0.)
+            low = mid;
+        else
+            high = mid;
+    }
+
+    double side = turn(low, high);
+    return (side > 0.) - (side < 0.);
 }
 
 bool inside_polygon(const Eigen::Vector2d& point, const Polygon& polygon)
 {
+    // Points on the boundary of a convex polygon are left to the winding number, whose rules decide them
+    if (polygon.is_convex() && polygon.n_points() >= MIN_BINARY_SEARCH_POINTS) {
+        int side = convex_side(point, polygon);
+        if (side != 0)
+            return (side > 0) == polygon.is_solid();
+    }
+
+    // Vertex coordinates from the facet arrays, which avoids wrapping every index
+    const Eigen::ArrayXd& xs = polygon.xs();
+    const Eigen::ArrayXd& ys = polygon.ys();
+    int n = polygon.n_points();
+
     int wn = 0;
 
-    for (int i = 0; i < polygon.n_points(); i++) {       // edge from vertex[i] to vertex[i+1]
-        if (polygon[i].y() <= point.y()) {                          // point above vertex[i]
-            if (polygon[i+1].y() > point.y())                       // upward crossing
-                if (is_left(polygon[i], polygon[i+1], point) > 0)   // point left of edge
+    for (int i = 0; i < n; i++) {                                   // edge from vertex[i] to vertex[i+1]
+        int j = i + 1 < n ? i + 1 : 0;
+        Eigen::Vector2d vi{xs(i), ys(i)}, vj{xs(j), ys(j)};
+
+        if (vi.y() <= point.y()) {                                  // point above vertex[i]
+            if (vj.y() > point.y())                                 // upward crossing
+                if (is_left(vi, vj, point) > 0)                     // point left of edge
                     wn++;                                           // valid up intersect
         }
         else {                                                      // point below vertex[i]
-            if (polygon[i+1].y() <= point.y())                      // downward crossing
-                if (is_left(polygon[i], polygon[i+1], point) <= 0)  // point right of edge
+            if (vj.y() <= point.y())                                // downward crossing
+                if (is_left(vi, vj, point) <= 0)                    // point right of edge
                     wn--;                                           // valid down intersect
         }
     }
@@ -113,96 +245,122 @@ bool inside_polygon(const Eigen::Vector2d& point, const Polygon& polygon)
 
 bool inside_any_polygon(const Eigen::Vector2d& point, const std::vector<Polygon>& polygons)
 {
-    for (auto polygon : polygons) {
+    for (const Polygon& polygon : polygons) {
         if (inside_polygon(point, polygon))
             return true;
     }
     return false;
 }
 
-double cross2d(const Eigen::Vector2d& u, const Eigen::Vector2d& v)
+// Whether r is in the bounding box of p and q, which for three points on a line is whether r is on the segment pq
+bool in_box(const Eigen::Vector2d& r, const Eigen::Vector2d& p, const Eigen::Vector2d& q)
 {
-    return u.x() * v.y() - u.y() * v.x();
+    return std::min(p.x(), q.x()) <= r.x() && r.x() <= std::max(p.x(), q.x())
+        && std::min(p.y(), q.y()) <= r.y() && r.y() <= std::max(p.y(), q.y());
 }
 
-bool point_in_segment(const Eigen::Vector2d& point, const std::pair<Eigen::Vector2d, Eigen::Vector2d>& segment)
+/*  Tests if two segments intersect
+
+    Inputs:
+        ab, cd: pairs of points that form finite line segments
+
+    Returns:
+        0 if the segments do not intersect
+        1 if the segments intersect at a single point, including where they only touch
+        2 if the segments are colinear and overlap, including where they only touch at an end
+
+    Every decision is made with exact orientations and comparisons of the input coordinates, so
+    near-degenerate segments are classified correctly. A segment whose ends are the same point is a
+    point, which intersects the other segment if it lies on it.
+*/
+int segments_intersect(const std::pair<Eigen::Vector2d, Eigen::Vector2d>& ab, const std::pair<Eigen::Vector2d, Eigen::Vector2d>& cd)
 {
-    double eps = std::numeric_limits<double>::epsilon();
+    const Eigen::Vector2d& a = ab.first;
+    const Eigen::Vector2d& b = ab.second;
+    const Eigen::Vector2d& c = cd.first;
+    const Eigen::Vector2d& d = cd.second;
 
-    if (std::abs(segment.first.x() - segment.second.x()) > eps) {   // Segment is not vertical, test x coordinate
-        if (segment.first.x() <= point.x() && point.x() <= segment.second.x())
-            return true;
-        if (segment.first.x() >= point.x() && point.x() >= segment.second.x())
-            return true;
+    if (a == b) {
+        if (c == d)
+            return a == c ? 1 : 0;
+
+        return triangle_orientation(c, d, a) == 0 && in_box(a, c, d) ? 1 : 0;
     }
-    else {
-        if (segment.first.y() <= point.y() && point.y() <= segment.second.y())   // Segment is vertical, test y coordinate
-            return true;
-        if (segment.first.y() >= point.y() && point.y() >= segment.second.y())
-            return true;
+
+    if (c == d)
+        return triangle_orientation(a, b, c) == 0 && in_box(c, a, b) ? 1 : 0;
+
+    int c_side = triangle_orientation(a, b, c);
+    int d_side = triangle_orientation(a, b, d);
+
+    if (c_side == 0 && d_side == 0) {
+        if (in_box(c, a, b) || in_box(d, a, b) || in_box(a, c, d))
+            return 2;   // Overlapping
+
+        return 0;       // Colinear but not overlapping
     }
 
-    return false;
-}
+    if (c_side * d_side > 0)
+        return 0;       // cd is on one side of ab
 
-int segments_intersect(const std::pair<Eigen::Vector2d, Eigen::Vector2d>& ab, const std::pair<Eigen::Vector2d, Eigen::Vector2d>& cd)
-{
-    double eps = std::numeric_limits<double>::epsilon();
+    int a_side = triangle_orientation(c, d, a);
+    int b_side = triangle_orientation(c, d, b);
 
-    Eigen::Vector2d u = ab.second - ab.first;
-    Eigen::Vector2d v = cd.second - cd.first;
-    Eigen::Vector2d w = ab.first - cd.first;
-    double D = cross2d(u, v);
+    if (a_side * b_side > 0)
+        return 0;       // ab is on one side of cd
 
-    // Test if the segments are parallel
-    if (std::abs(D) < eps) {
-        double Du = std::abs(cross2d(u, w));
-        double Dv = std::abs(cross2d(v, w));
+    return 1;
+}
 
-        if (Du > eps || Dv > eps)
-            return 0;   // Not colinear, therefore just parallel
+/*  Conservative filter for segment_intersects_polygon, over a block of the polygon's facets
 
-        double du = u.dot(u);
-        double dv = v.dot(v);
+    Computes the cross products of the segment and the facets with fixed size Eigen arrays, which
+    vectorize over the facets of the block. A facet is ruled out only if the segment and the facet
+    are certainly not parallel and the intersection of their lines is certainly off one of them,
+    allowing for the rounding errors of the products. The facets left in the returned mask are
+    left to segments_intersect, so the codes are exactly the same as testing every facet.
+*/
+typedef Eigen::Array<double, FACET_BLOCK_SIZE, 1> FacetBlock;
+typedef Eigen::Array<bool, FACET_BLOCK_SIZE, 1> FacetMask;
 
-        if (du < eps && dv < eps) {
-            Eigen::Vector2d diff = ab.first - cd.first;
-            if (diff.dot(diff) < eps)
-                return 0;
-        }
+FacetMask facets_maybe_intersected(const Eigen::Vector2d& a, const Eigen::Vector2d& u, const Polygon& polygon, int block)
+{
+    double eps = std::numeric_limits<double>::epsilon();
+    double slack = 8 * eps;
 
-        if (du < eps) {     // First segment degnerate
-            if (point_in_segment(ab.first, cd)) 
-                return 1;   // and in the second segment
-            
-            return 0;       // but not in the second segment
-        }
+    int offset = block * FACET_BLOCK_SIZE;
+    FacetBlock dxs = polygon.dxs().segment<FACET_BLOCK_SIZE>(offset);
+    FacetBlock dys = polygon.dys().segment<FACET_BLOCK_SIZE>(offset);
+    FacetBlock wxs = a.x() - polygon.xs().segment<FACET_BLOCK_SIZE>(offset);
+    FacetBlock wys = a.y() - polygon.ys().segment<FACET_BLOCK_SIZE>(offset);
 
-        if (dv < eps) {     // Second segment degenerate
-            if (point_in_segment(cd.first, ab))
-                return 1;   // and in the first segment
-            
-            return 0;       // but not in the first segment
-        }
+    // Cross products of u and v, u and w, and v and w, with bounds on their rounding errors
+    FacetBlock D = u.x() * dys - u.y() * dxs;
+    FacetBlock D_error = slack * ((u.x() * dys).abs() + (u.y() * dxs).abs());
 
-        if (point_in_segment(ab.first, cd) || point_in_segment(ab.second, cd))
-            return 2;       // Overlapping
+    FacetBlock signs = D.sign();
+    FacetBlock n1 = signs * (u.x() * wys - u.y() * wxs);
+    FacetBlock n1_error = slack * ((u.x() * wys).abs() + (u.y() * wxs).abs());
+    FacetBlock n2 = signs * (dxs * wys - dys * wxs);
+    FacetBlock n2_error = slack * ((dxs * wys).abs() + (dys * wxs).abs());
 
-        return 0;           // Colinear but not overlapping
-    }
+    FacetBlock abs_D = D.abs();
+    FacetBlock upper = (abs_D + D_error) * (1 + slack);
 
-    // Segments are skew, so they may intersect at a single point
-    // Check intersection along S1
-    double t1 = cross2d(u, w) / D;
-    if (t1 < 0 || t1 > 1)
-        return 0;
+    FacetMask skew = abs_D - D_error >= eps;
+    FacetMask t1_outside = (n1 < -n1_error) || (n1 - n1_error > upper);
+    FacetMask t2_outside = (n2 < -n2_error) || (n2 - n2_error > upper);
 
-    // Check intersection along S2
-    double t2 = cross2d(v, w) / D;
-    if (t2 < 0 || t2 > 1)
-        return 0;
+    return !(skew && (t1_outside || t2_outside));
+}
 
-    return 1;
+// Whether the segment is wholly to one side of the polygon's bounding box, so it cannot meet any facet
+bool clear_of_bounds(const std::pair<Eigen::Vector2d, Eigen::Vector2d>& segment, const Polygon& polygon)
+{
+    Eigen::Vector2d segment_min = segment.first.cwiseMin(segment.second);
+    Eigen::Vector2d segment_max = segment.first.cwiseMax(segment.second);
+
+    return (segment_max.array() < polygon.bounds_min().array()).any() || (segment_min.array() > polygon.bounds_max().array()).any();
 }
 
 /*  Tests if a segment intersects a polygon
@@ -219,7 +377,19 @@ int segments_intersect(const std::pair<Eigen::Vector2d, Eigen::Vector2d>& ab, co
 */
 int segment_intersects_polygon(const std::pair<Eigen::Vector2d, Eigen::Vector2d>& segment, const Polygon& polygon)
 {
+    if (clear_of_bounds(segment, polygon))
+        return polygon.is_hollow() ? 3 : 0;
+
+    Eigen::Vector2d u = segment.second - segment.first;
+    FacetMask candidates;
+
     for (int i=0, j=1; i < polygon.n_points(); i++, j++) {
+        if (i % FACET_BLOCK_SIZE == 0)
+            candidates = facets_maybe_intersected(segment.first, u, polygon, i / FACET_BLOCK_SIZE);
+
+        if (!candidates(i % FACET_BLOCK_SIZE))
+            continue;
+
         std::pair<Eigen::Vector2d, Eigen::Vector2d> facet = {polygon[i], polygon[j]};
 
         int code = segments_intersect(segment, facet);
@@ -227,10 +397,31 @@ int segment_intersects_polygon(const std::pair<Eigen::Vector2d, Eigen::Vector2d>
             return code;
     }
 
-    if (inside_polygon(segment.first, polygon)) {
-        if (inside_polygon(segment.second, polygon))
-            return 3;
-    }
+    // A segment that meets no facet has both ends on the same side of the boundary
+    if (inside_polygon(segment.first, polygon))
+        return 3;
 
     return 0;
-}
\ No newline at end of file
+}
+
+double distance_to_boundary(const Eigen::Vector2d& point, const Polygon& polygon)
+{
+    // The facet arrays are padded to whole blocks with a repeat of the last facet, which leaves the minimum alone
+    FacetBlock closest = FacetBlock::Constant(INFINITY);
+
+    for (int offset = 0; offset < polygon.xs().size(); offset += FACET_BLOCK_SIZE) {
+        FacetBlock dxs = polygon.dxs().segment<FACET_BLOCK_SIZE>(offset);
+        FacetBlock dys = polygon.dys().segment<FACET_BLOCK_SIZE>(offset);
+        FacetBlock wxs = point.x() - polygon.xs().segment<FACET_BLOCK_SIZE>(offset);
+        FacetBlock wys = point.y() - polygon.ys().segment<FACET_BLOCK_SIZE>(offset);
+
+        // Nearest point of each facet, as a fraction of the way along it, with repeated vertices as points
+        FacetBlock lengths = dxs * dxs + dys * dys;
+        FacetBlock ts = (lengths > 0.).select(((wxs * dxs + wys * dys) / lengths).max(0.).min(1.), 0.);
+
+        FacetBlock exs = wxs - ts * dxs, eys = wys - ts * dys;
+        closest = closest.min(exs * exs + eys * eys);
+    }
+
+    return std::sqrt(closest.minCoeff());
+}
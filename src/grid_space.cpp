@@ -0,0 +1,238 @@
+#include <cmath>
+#include <limits>
+#include "grid_space.hpp"
+
+
+/*  Squared distance transform of one row of samples f (0 at occupied cells, INFINITY elsewhere) as
+    the lower envelope of the parabolas rooted at the finite samples, of which f[0] has to be one
+*/
+void distance_transform_1d(const std::vector<double>& f, std::vector<double>& d)
+{
+    int n = f.size();
+    std::vector<int> v(n);
+    std::vector<double> z(n + 1);
+
+    int k = 0;
+    v[0] = 0;
+    z[0] = -INFINITY;
+    z[1] = INFINITY;
+
+    for (int q = 1; q < n; q++) {
+        if (f[q] == INFINITY)
+            continue;
+
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2. * q - 2. * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2. * q - 2. * v[k]);
+        }
+
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = INFINITY;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k + 1] < q)
+            k++;
+
+        d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+    }
+}
+
+Eigen::MatrixXd distance_transform(const OccupancyGrid& occupancy)
+{
+    // Padded with a border of occupied cells, for the outside of the grid
+    int rows = occupancy.rows() + 2, cols = occupancy.cols() + 2;
+    Eigen::MatrixXd squared(rows, cols);
+
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            bool border = i == 0 || j == 0 || i == rows - 1 || j == cols - 1;
+            squared(i, j) = border || occupancy(i - 1, j - 1) ? 0. : INFINITY;
+        }
+    }
+
+    std::vector<double> f, d;
+
+    f.resize(rows);
+    d.resize(rows);
+    for (int j = 0; j < cols; j++) {
+        for (int i = 0; i < rows; i++)
+            f[i] = squared(i, j);
+
+        distance_transform_1d(f, d);
+
+        for (int i = 0; i < rows; i++)
+            squared(i, j) = d[i];
+    }
+
+    f.resize(cols);
+    d.resize(cols);
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++)
+            f[j] = squared(i, j);
+
+        distance_transform_1d(f, d);
+
+        for (int j = 0; j < cols; j++)
+            squared(i, j) = d[j];
+    }
+
+    return squared.block(1, 1, occupancy.rows(), occupancy.cols()).cwiseSqrt();
+}
+
+GridSpace::GridSpace(const OccupancyGrid& occupancy, double resolution, const Eigen::Vector2d& origin, long seed)
+{
+    _occupancy = occupancy;
+    _resolution = resolution;
+    _origin = origin;
+
+    set_seed(seed);
+
+    // A point is at most half a diagonal from its cell's center, and so is an occupied cell's center from its edge
+    _clearance = distance_transform(occupancy).array() - std::sqrt(2.);
+
+    for (int i = 0; i < occupancy.rows(); i++) {
+        for (int j = 0; j < occupancy.cols(); j++) {
+            if (!occupancy(i, j))
+                _free_cells.push_back(i * occupancy.cols() + j);
+        }
+    }
+
+    set_state_size(2);
+}
+
+Eigen::MatrixXd GridSpace::sample_free_space(int n) const
+{
+    RandomStream stream = next_stream();
+    return sample_free_space(n, stream);
+}
+
+Eigen::MatrixXd GridSpace::sample_free_space(int n, RandomStream& stream) const
+{
+    if (_free_cells.empty())
+        throw NoFreeSpaceException{};
+
+    Eigen::MatrixXd samples(n, 2);
+    for (int k = 0; k < n; k++) {
+        int cell = _free_cells[std::min((int)(stream.uniform() * _free_cells.size()), (int)_free_cells.size() - 1)];
+        int i = cell / _occupancy.cols(), j = cell % _occupancy.cols();
+
+        samples(k, 0) = _origin.x() + (j + stream.uniform()) * _resolution;
+        samples(k, 1) = _origin.y() + (i + stream.uniform()) * _resolution;
+    }
+
+    return samples;
+}
+
+Eigen::MatrixXd GridSpace::sample_space(int n, RandomStream& stream) const
+{
+    Eigen::Vector2d extent{_occupancy.cols() * _resolution, _occupancy.rows() * _resolution};
+
+    Eigen::MatrixXd samples(n, 2);
+    draw_candidates(samples, _origin, _origin + extent, stream);
+
+    return samples;
+}
+
+bool GridSpace::valid_state(const Eigen::VectorXd& state) const
+{
+    double x = (state(0) - _origin.x()) / _resolution;
+    double y = (state(1) - _origin.y()) / _resolution;
+
+    // Written so that NaNs are invalid
+    if (!(x >= 0. && y >= 0. && x < _occupancy.cols() && y < _occupancy.rows()))
+        return false;
+
+    return !_occupancy((int)y, (int)x);
+}
+
+bool GridSpace::valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    if (!valid_state(a) || !valid_state(b))
+        return false;
+
+    // In cell units, along a + t (b - a) for t in [0, 1]
+    Eigen::Vector2d start = (a.head<2>() - _origin) / _resolution;
+    Eigen::Vector2d direction = (b.head<2>() - a.head<2>()) / _resolution;
+    double length = direction.norm();
+
+    if (length == 0.)
+        return true;
+
+    int step_x = direction.x() > 0. ? 1 : -1;
+    int step_y = direction.y() > 0. ? 1 : -1;
+    double delta_x = direction.x() != 0. ? 1. / std::abs(direction.x()) : INFINITY;
+    double delta_y = direction.y() != 0. ? 1. / std::abs(direction.y()) : INFINITY;
+
+    int i, j;
+    double next_x, next_y;
+
+    // Sets the cell and the parameters where the walk next crosses a column and a row boundary
+    auto start_at = [&](double t) {
+        Eigen::Vector2d point = start + t * direction;
+        j = (int)std::floor(point.x());
+        i = (int)std::floor(point.y());
+
+        next_x = direction.x() == 0. ? INFINITY : (j + (step_x > 0) - start.x()) / direction.x();
+        next_y = direction.y() == 0. ? INFINITY : (i + (step_y > 0) - start.y()) / direction.y();
+    };
+
+    start_at(0.);
+    double t = 0.;
+
+    while (true) {
+        if (occupied(i, j))
+            return false;
+
+        // Far from obstacles, everything within the clearance of the point is free
+        double clearance = _clearance(i, j);
+        if (clearance >= 1.) {
+            t += clearance / length;
+            if (t >= 1.)
+                return true;
+
+            start_at(t);
+            continue;
+        }
+
+        if (std::min(next_x, next_y) >= 1.)
+            return true;
+
+        if (next_x < next_y) {
+            t = next_x;
+            j += step_x;
+            next_x += delta_x;
+        }
+        else if (next_y < next_x) {
+            t = next_y;
+            i += step_y;
+            next_y += delta_y;
+        }
+        else {
+            // Through a corner, touching the cells on both sides of it
+            if (occupied(i, j + step_x) || occupied(i + step_y, j))
+                return false;
+
+            t = next_x;
+            i += step_y;
+            j += step_x;
+            next_x += delta_x;
+            next_y += delta_y;
+        }
+    }
+}
+
+double GridSpace::transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    Eigen::VectorXd ab = b - a;
+    return ab.dot(ab);
+}
+
+Eigen::MatrixXd GridSpace::distance_field() const
+{
+    return (_clearance.array() + std::sqrt(2.)) * _resolution;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+
+/*  Axis-aligned boxes in n dimensions, one row per box
+
+    Eigen stores the matrices column by column, so the corners of every box along one axis are
+    contiguous and the tests below run over a block of boxes at once, one axis at a time. Boxes
+    are closed: a point on a face is inside.
+*/
+struct BoxSet {
+    Eigen::MatrixXd lower, upper;
+
+    int size() const {return lower.rows();}
+};
+
+// Whether any of the boxes contains the point
+bool boxes_contain(const BoxSet& boxes, const Eigen::VectorXd& point);
+
+/*  Whether the segment a + t (b - a), t in [0, 1], touches any of the boxes, by the slab method
+
+    inverse is 1 / (b - a) along each axis, from segment_inverse, so it is worked out once per
+    segment rather than once per box. It is infinite along the axes the segment does not move along.
+*/
+bool segment_touches_boxes(const BoxSet& boxes, const Eigen::VectorXd& a, const Eigen::VectorXd& inverse);
+
+Eigen::VectorXd segment_inverse(const Eigen::VectorXd& a, const Eigen::VectorXd& b);
+
+/*  Uniform grid over up to three axes of a set of boxes
+
+    The grid spans the axes where the boxes are narrowest compared to how far they spread, since
+    those split them best, and a grid over every axis of a high dimensional space would have far
+    too many cells. Each cell keeps its own copy of the boxes that overlap it, so a query tests the
+    boxes of each cell it visits in one contiguous block.
+*/
+class BoxIndex {
+    std::vector<int> _axes;
+    Eigen::VectorXd _origin, _cell_size;
+    Eigen::VectorXi _counts, _strides;
+
+    std::vector<BoxSet> _cells;
+
+    int index(int q, double value) const;
+
+public:
+    BoxIndex() {}
+    BoxIndex(const BoxSet& boxes);
+
+    // Cell that contains the point, or -1 if the point is outside the grid and so outside every box
+    int cell_at(const Eigen::VectorXd& point) const;
+
+    /*  Cells that the segment from a to b passes through, each listed once. Every cell the
+        segment touches is included, along with some of their neighbours.
+    */
+    std::vector<int> cells_along(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+    const BoxSet& cell(int i) const {return _cells[i];}
+
+    // Getters
+    bool empty() const {return _cells.empty();}
+    int n_cells() const {return _cells.size();}
+    const std::vector<int>& axes() const {return _axes;}
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Eigen/Core>
+#include "box_index.hpp"
+#include "random_stream.hpp"
+#include "search_space.hpp"
+
+struct BadBoxException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "Every box needs its lower corner at or below its upper corner, with one coordinate per axis of the space";
+    }
+};
+
+/*  Search space in any number of dimensions with axis-aligned boxes as obstacles
+
+    Row i of box_lower and box_upper holds the corners of box i, and lower and upper are the corners
+    of the space. Boxes are closed, so a state on a face is in collision. Queries run the slab test
+    over blocks of boxes at once, against every box when there are few of them and against the
+    boxes in the cells of a grid index along the way when there are many.
+*/
+class BoxSpace : public SearchSpace {
+    BoxSet _boxes;
+    BoxIndex _index;
+
+    Eigen::VectorXd _lower, _upper;
+
+    public:
+        BoxSpace(const Eigen::MatrixXd& box_lower, const Eigen::MatrixXd& box_upper, const Eigen::VectorXd& lower,
+            const Eigen::VectorXd& upper, long seed = -1);
+
+        Eigen::MatrixXd sample_free_space(int n) const;
+        Eigen::MatrixXd sample_free_space(int n, RandomStream& stream) const;
+
+        Eigen::MatrixXd sample_space(int n, RandomStream& stream) const;
+
+        bool valid_state(const Eigen::VectorXd& state) const;
+
+        bool valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double sampling_volume() const {return (_upper - _lower).prod();}
+
+        // Getters
+        const Eigen::MatrixXd& get_box_lower() const {return _boxes.lower;}
+        const Eigen::MatrixXd& get_box_upper() const {return _boxes.upper;}
+        const Eigen::VectorXd& get_lower() const {return _lower;}
+        const Eigen::VectorXd& get_upper() const {return _upper;}
+        int n_boxes() const {return _boxes.size();}
+        bool is_indexed() const {return !_index.empty();}
+
+    private:
+        bool inside_obstacle(const Eigen::VectorXd& point) const;
+};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+#include "roadmap.hpp"
+#include "search_roadmap.hpp"
+
+/* Upward edge of the hierarchy, where middle is the contracted node of a shortcut (-1 otherwise) */
+
+struct HierarchyEdge {
+    int target;
+    double cost;
+    int middle;
+};
+
+/*  Contraction hierarchy index over a static roadmap
+
+    Nodes are contracted in order of their edge difference (shortcuts added minus edges removed),
+    inserting a shortcut between two neighbors whenever a bounded witness search finds no path
+    around the contracted node that is as short. Queries are a bidirectional Dijkstra search that
+    only follows edges up the hierarchy, and shortcuts are unpacked into the roadmap's states so the
+    result has the same format as dijkstra. The index is a snapshot: nodes added to the roadmap after
+    construction are not seen by it.
+*/
+class ContractionHierarchy {
+    RoadmapGraph _graph;
+
+    std::vector<int> _rank;
+    std::vector<std::vector<HierarchyEdge>> _upward;
+    int _n_shortcuts = 0;
+
+    void unpack_edge(int u, int w, std::vector<int>& path) const;
+    int middle_of(int u, int w) const;
+
+public:
+    ContractionHierarchy(const Roadmap& roadmap);
+
+    Eigen::MatrixXd query(const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state) const;
+    Eigen::MatrixXd query(const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics) const;
+
+    // Getters
+    int get_n_states() const {return _graph.n_nodes();}
+    int get_n_shortcuts() const {return _n_shortcuts;}
+};
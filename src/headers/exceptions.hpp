@@ -19,6 +19,27 @@ struct BadStateSizeException : public std::exception
         if (!_msg)
             return "Given state does not have the same size as data structure's state.";
         
+        return _msg;
+    }
+};
+
+/* Generic exception for arguments outside the range an algorithm works for */
+
+struct BadParameterException : public std::exception
+{
+    const char* _msg = nullptr;
+
+    BadParameterException() {};
+
+    BadParameterException(const char* msg) {
+        _msg = msg;
+    }
+
+    const char* what() const throw()
+    {
+        if (!_msg)
+            return "Given parameter is outside the range the algorithm works for.";
+
         return _msg;
     }
 };
\ No newline at end of file
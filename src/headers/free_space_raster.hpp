@@ -0,0 +1,47 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+#include "geometry.hpp"
+#include "polygon_index.hpp"
+#include "random_stream.hpp"
+
+/*  Occupancy raster of a polygonal map, for drawing free space samples without rejection sampling
+
+    The map is split into square cells, which are free, blocked (wholly inside an obstacle) or mixed
+    (crossed by an obstacle's boundary). Runs of free cells along each row are merged into
+    rectangles. Samples pick a rectangle or mixed cell with probability proportional to its area, in
+    O(log n), then a point uniformly inside it. Only points in mixed cells can land in an obstacle
+    and need to be checked, so with a fine raster almost no draws are thrown away.
+*/
+class FreeSpaceRaster {
+    struct Rectangle {
+        Eigen::Vector2d lower, upper;
+        bool mixed;
+    };
+
+    std::vector<Rectangle> _rectangles;
+    std::vector<double> _cumulative_areas;
+
+    int _n_free = 0, _n_mixed = 0, _n_blocked = 0;
+
+public:
+    FreeSpaceRaster() {}
+
+    // Resolution is the number of cells along the longer side of the map
+    FreeSpaceRaster(const std::vector<Polygon>& polygons, const PolygonIndex& index,
+        std::pair<double, double> xrange, std::pair<double, double> yrange, int resolution);
+
+    /*  Point drawn uniformly from the cells that are not blocked. Sets mixed if the point's cell
+        is crossed by an obstacle, in which case the point may be in collision.
+    */
+    Eigen::Vector2d draw(RandomStream& stream, bool& mixed) const;
+
+    bool empty() const {return _rectangles.empty();}
+
+    // Getters
+    int n_free_cells() const {return _n_free;}
+    int n_mixed_cells() const {return _n_mixed;}
+    int n_blocked_cells() const {return _n_blocked;}
+};
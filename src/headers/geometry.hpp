@@ -3,11 +3,27 @@
 #include <vector>
 #include <Eigen/Core>
 
+// Number of polygon facets tested together by the vectorized facet tests
+const int FACET_BLOCK_SIZE = 8;
+
 class Polygon {
     Eigen::MatrixX2d _points;
     int _n_points;
     int _orientation;
 
+    // Strictly convex and winding around once, which the point and segment tests have fast paths for
+    bool _convex;
+
+    /*  Vertex coordinates and facet vectors (from vertex i to vertex i + 1) in SoA layout, for the
+        vectorized facet tests. They are padded to whole blocks of FACET_BLOCK_SIZE by repeating the
+        last facet.
+    */
+    Eigen::ArrayXd _xs, _ys;
+    Eigen::ArrayXd _dxs, _dys;
+
+    // Corners of the bounding box
+    Eigen::Vector2d _min, _max;
+
 public:
     Polygon(Eigen::MatrixX2d points);
 
@@ -25,6 +41,14 @@ public:
         return _n_points;
     }
 
+    const Eigen::ArrayXd& xs() const {return _xs;}
+    const Eigen::ArrayXd& ys() const {return _ys;}
+    const Eigen::ArrayXd& dxs() const {return _dxs;}
+    const Eigen::ArrayXd& dys() const {return _dys;}
+
+    const Eigen::Vector2d& bounds_min() const {return _min;}
+    const Eigen::Vector2d& bounds_max() const {return _max;}
+
     /*  Orientation of the polygon
         Returns: 
             >0 if orientation is counter-clockwise
@@ -41,6 +65,10 @@ public:
     bool is_hollow() const {
         return _orientation < 0;
     }
+
+    bool is_convex() const {
+        return _convex;
+    }
 };
 
 bool inside_polygon(const Eigen::Vector2d& point, const Polygon& polygon);
@@ -48,3 +76,6 @@ bool inside_any_polygon(const Eigen::Vector2d& point, const std::vector<Polygon>
 
 int segments_intersect(const std::pair<Eigen::Vector2d, Eigen::Vector2d>& ab, const std::pair<Eigen::Vector2d, Eigen::Vector2d>& cd);
 int segment_intersects_polygon(const std::pair<Eigen::Vector2d, Eigen::Vector2d>& segment, const Polygon& polygon);
+
+// Distance from the point to the nearest facet of the polygon, whichever side of it the point is on
+double distance_to_boundary(const Eigen::Vector2d& point, const Polygon& polygon);
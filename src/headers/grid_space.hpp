@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+#include "random_stream.hpp"
+#include "search_space.hpp"
+
+typedef Eigen::Matrix<int, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> OccupancyGrid;
+
+/*  Search space over a 2D occupancy grid
+
+    Cell (i, j) of the grid is the square [x0 + j r, x0 + (j + 1) r) x [y0 + i r, y0 + (i + 1) r),
+    where (x0, y0) is the origin and r the resolution, and is occupied if its value is nonzero.
+    Everything outside the grid is treated as occupied.
+
+    Transitions are checked by walking the cells along them, cell by cell near obstacles and in long
+    steps elsewhere: a distance field computed when the space is built bounds how far every point
+    of a cell is from the nearest occupied cell. A transition through the exact corner between cells
+    counts as touching both of the other cells at that corner. Free space samples pick a free cell
+    uniformly and a point uniformly inside it, so they need no rejection sampling, and ignore the
+    sampling mode.
+*/
+class GridSpace : public SearchSpace {
+    OccupancyGrid _occupancy;
+    double _resolution;
+    Eigen::Vector2d _origin;
+
+    // Lower bound on the distance, in cells, from any point of a cell to the nearest occupied cell
+    Eigen::MatrixXd _clearance;
+
+    std::vector<int> _free_cells;
+
+    bool occupied(int i, int j) const {
+        return i < 0 || j < 0 || i >= _occupancy.rows() || j >= _occupancy.cols() || _occupancy(i, j);
+    }
+
+    public:
+        GridSpace(const OccupancyGrid& occupancy, double resolution, const Eigen::Vector2d& origin = Eigen::Vector2d::Zero(), long seed = -1);
+
+        Eigen::MatrixXd sample_free_space(int n) const;
+        Eigen::MatrixXd sample_free_space(int n, RandomStream& stream) const;
+
+        Eigen::MatrixXd sample_space(int n, RandomStream& stream) const;
+
+        bool valid_state(const Eigen::VectorXd& state) const;
+
+        bool valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        // Area of the free cells, which are all that samples are drawn from
+        double sampling_volume() const {return _free_cells.size() * _resolution * _resolution;}
+
+        // Distance from the center of each cell to the center of the nearest occupied cell, in world units
+        Eigen::MatrixXd distance_field() const;
+
+        // Getters
+        const OccupancyGrid& get_occupancy() const {return _occupancy;}
+        double get_resolution() const {return _resolution;}
+        const Eigen::Vector2d& get_origin() const {return _origin;}
+        int n_free_cells() const {return _free_cells.size();}
+};
+
+/*  Euclidean distance transform (Felzenszwalb and Huttenlocher)
+
+    Distance from the center of each cell to the center of the nearest occupied cell, in cells, with
+    everything outside the grid occupied.
+*/
+Eigen::MatrixXd distance_transform(const OccupancyGrid& occupancy);
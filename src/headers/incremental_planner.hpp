@@ -0,0 +1,48 @@
+#pragma once
+
+#include <queue>
+#include <vector>
+#include <Eigen/Core>
+#include "roadmap.hpp"
+#include "search_roadmap.hpp"
+
+/*  Incremental replanning between a fixed start and goal on a roadmap (Lifelong Planning A*)
+
+    The planner keeps its own copy of the roadmap's edge costs. After edge costs change, including
+    being set to INFINITY when an edge becomes blocked, plan repairs only the part of the previous
+    search that the changes affect instead of starting over. The roadmap's landmark tables, if any,
+    are used as the heuristic; lowering an edge below its original cost makes them unsafe, so the
+    planner then drops them and searches again from scratch.
+*/
+class IncrementalPlanner {
+    typedef std::pair<double, double> Key;
+    typedef std::pair<Key, int> KeyIndexPair;
+
+    RoadmapGraph _graph;
+    std::vector<double> _costs;             // Current cost of each edge of the graph
+    Eigen::MatrixXd _landmark_distances;
+
+    int _start;
+    int _goal;
+
+    std::vector<double> _g;
+    std::vector<double> _rhs;
+    std::priority_queue<KeyIndexPair, std::vector<KeyIndexPair>, std::greater<KeyIndexPair>> _open;
+
+    double heuristic(int v) const;
+    Key calculate_key(int v) const;
+    void update_vertex(int v);
+    void reset();
+
+public:
+    IncrementalPlanner(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state);
+
+    void set_edge_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double cost);
+    double edge_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+    Eigen::MatrixXd plan();
+    Eigen::MatrixXd plan(SearchStatistics& statistics);
+
+    // Cost of the path found by the last call to plan (INFINITY if the goal is unreachable)
+    double get_path_cost() const {return _g[_goal];}
+};
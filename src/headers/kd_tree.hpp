@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <utility>
 #include <vector>
 #include <Eigen/Core>
 
@@ -26,6 +27,7 @@ struct EmptyTreeException : public std::exception
 
 struct kdNode {
     Eigen::VectorXd state;
+    int id;     // Order in which the state was added to the tree
 
     std::shared_ptr<kdNode> left;
     std::shared_ptr<kdNode> right;
@@ -45,9 +47,14 @@ public:
     void append_state(const Eigen::VectorXd& state);
 
     Eigen::VectorXd nearest_neighbor(const Eigen::VectorXd& search_state) const;
+    int nearest_neighbor_id(const Eigen::VectorXd& search_state) const;
 
     Eigen::MatrixXd k_nearest_neighbors(const Eigen::VectorXd& search_state, int k) const;
 
+    // Ids and distances of the states within the radius of the search state, nearest first
+    std::pair<Eigen::VectorXi, Eigen::VectorXd> radius_search(const Eigen::VectorXd& search_state, double radius) const;
+    Eigen::MatrixXd states_within(const Eigen::VectorXd& search_state, double radius) const;
+
     Eigen::MatrixXd at_depth(int depth) const;
 
     int count_states() const;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <Eigen/Core>
+#include "random_stream.hpp"
+
+/*  Scrambled Halton sequence in d dimensions
+
+    Dimension j is the radical inverse of the point's index in the j-th prime base, with the digits
+    passed through a random permutation of that base (keeping 0 fixed) to break up the correlations
+    between the higher dimensions. Points cover the unit cube far more evenly than independent
+    uniform samples. fill and next carry on from one call to the next, and calls from several
+    threads each take a run of their own, so together they still cover one consecutive run.
+*/
+class HaltonSequence {
+    std::vector<int> _bases;
+    std::vector<std::vector<int>> _permutations;
+    std::atomic<long> _index{1};    // Index 0 is the origin in every base, so it is skipped
+
+public:
+    HaltonSequence() {}
+    HaltonSequence(int dimension, uint64_t seed);
+    HaltonSequence(const HaltonSequence& other) : _bases(other._bases), _permutations(other._permutations), _index(other._index.load()) {}
+
+    HaltonSequence& operator=(const HaltonSequence& other) {
+        _bases = other._bases;
+        _permutations = other._permutations;
+        _index = other._index.load();
+        return *this;
+    }
+
+    // Fills the block row by row with the next points, column j scaled to [lower(j), upper(j))
+    void fill(Eigen::Ref<Eigen::MatrixXd> block, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper);
+
+    // The same with the points from index start on
+    void fill(Eigen::Ref<Eigen::MatrixXd> block, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper, long start) const;
+    Eigen::MatrixXd next(int n);
+
+    void reset() {_index = 1;}
+
+    // Getters
+    int dimension() const {return _bases.size();}
+};
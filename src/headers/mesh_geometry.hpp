@@ -0,0 +1,75 @@
+#pragma once
+
+#include <exception>
+#include <Eigen/Core>
+
+/* Custom exceptions for meshes */
+
+struct BadMeshException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "Every face of a mesh has to index three of the mesh's vertices";
+    }
+};
+
+struct Triangle {
+    Eigen::Vector3d a, b, c;
+};
+
+/*  Ray from origin along direction, for t in [0, t_max], set up for the watertight triangle test
+
+    The axes are permuted so the direction's largest component is z, and the ray is sheared onto
+    the z axis. A segment from a to b is the ray from a along b - a with t_max = 1.
+*/
+struct Ray {
+    Eigen::Vector3d origin;
+    Eigen::Vector3d direction;
+    double t_max;
+
+    int kx, ky, kz;
+    double sx, sy, sz;
+
+    // Large rather than infinite where the direction is 0, so the box test never multiplies 0 by infinity
+    Eigen::Vector3d inverse_direction;
+
+    Ray(const Eigen::Vector3d& origin, const Eigen::Vector3d& direction, double t_max);
+
+    // Whether the ray passes through the box, allowing for rounding so no triangle inside it is missed
+    bool hits_box(const Eigen::Vector3d& lower, const Eigen::Vector3d& upper) const;
+};
+
+/*  Watertight ray-triangle test (Woop, Benthin and Wald)
+
+    Computes the edge functions of the triangle from the sheared vertices, so two triangles that
+    share an edge compute the same values for it and no ray slips between them. Rays parallel to the
+    triangle's plane miss it.
+
+    Returns:
+        0 if the ray misses the triangle
+        1 if the ray hits the inside of the triangle, at t
+        2 if the ray hits an edge or a vertex of the triangle, at t, where it may hit a neighbour too
+*/
+int ray_hits_triangle(const Ray& ray, const Triangle& triangle, double& t);
+
+/*  Closed triangle mesh, for one obstacle
+
+    Each row of faces holds the indices of a triangle's three vertices. Which points are inside is
+    only well defined if the mesh is closed, with every edge shared by two faces, which is not checked.
+*/
+class TriangleMesh {
+    Eigen::MatrixX3d _vertices;
+    Eigen::MatrixX3i _faces;
+
+public:
+    TriangleMesh(const Eigen::MatrixX3d& vertices, const Eigen::MatrixX3i& faces);
+
+    Triangle face(int i) const {
+        return {_vertices.row(_faces(i, 0)), _vertices.row(_faces(i, 1)), _vertices.row(_faces(i, 2))};
+    }
+
+    // Getters
+    const Eigen::MatrixX3d& vertices() const {return _vertices;}
+    const Eigen::MatrixX3i& faces() const {return _faces;}
+    int n_faces() const {return _faces.rows();}
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+#include "mesh_geometry.hpp"
+#include "random_stream.hpp"
+#include "search_space.hpp"
+#include "triangle_bvh.hpp"
+
+/*  Search space in 3D with closed triangle meshes as obstacles
+
+    A state is in collision if it is inside any of the meshes, by the parity of the number of times a
+    ray from it crosses each mesh, or on a mesh's surface. A transition is valid if it touches no
+    triangle. Both go through a bounding volume hierarchy over the triangles of every mesh.
+*/
+class MeshSpace : public SearchSpace {
+    std::vector<TriangleMesh> _meshes;
+
+    std::vector<Triangle> _triangles;
+    std::vector<int> _triangle_meshes;      // Mesh that each triangle belongs to
+    TriangleBVH _bvh;
+
+    std::pair<double, double> _xrange, _yrange, _zrange;
+
+    public:
+        MeshSpace(const std::vector<TriangleMesh>& meshes, std::pair<double, double> xrange, std::pair<double, double> yrange,
+            std::pair<double, double> zrange, long seed = -1);
+
+        Eigen::MatrixXd sample_free_space(int n) const;
+        Eigen::MatrixXd sample_free_space(int n, RandomStream& stream) const;
+
+        Eigen::MatrixXd sample_space(int n, RandomStream& stream) const;
+
+        bool valid_state(const Eigen::VectorXd& state) const;
+
+        bool valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double sampling_volume() const {return (upper() - lower()).prod();}
+
+        // Getters
+        const std::vector<TriangleMesh>& get_meshes() const {return _meshes;}
+        const TriangleBVH& get_bvh() const {return _bvh;}
+
+    private:
+        bool inside_obstacle(const Eigen::Vector3d& point) const;
+
+        Eigen::Vector3d lower() const {return {_xrange.first, _yrange.first, _zrange.first};}
+        Eigen::Vector3d upper() const {return {_xrange.second, _yrange.second, _zrange.second};}
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*  Fixed group of threads that all run the same task and then wait for each other
+
+    The calling thread takes part as thread 0, so a team of one runs tasks inline without starting
+    any threads. An exception thrown by a task is rethrown from run once every thread is done.
+*/
+class ThreadTeam {
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _start;
+    std::condition_variable _finish;
+
+    const std::function<void(int)>* _task = nullptr;
+    long _generation = 0;
+    int _n_running = 0;
+    bool _stopping = false;
+    std::exception_ptr _error;
+
+    void work(int thread_index);
+    void run_task(int thread_index);
+
+public:
+    ThreadTeam(int n_threads);
+    ~ThreadTeam();
+
+    ThreadTeam(const ThreadTeam&) = delete;
+    ThreadTeam& operator=(const ThreadTeam&) = delete;
+
+    void run(const std::function<void(int)>& task);
+
+    // Runs body(i) for every i in [0, n), splitting the range into one contiguous block per thread
+    void parallel_for(int n, const std::function<void(int)>& body);
+
+    int size() const {return _workers.size() + 1;}
+};
+
+// Number of threads to use when a caller asks for n_threads, where anything below 1 means all cores
+int resolve_n_threads(int n_threads);
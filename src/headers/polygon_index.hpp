@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+#include "geometry.hpp"
+
+/*  Uniform grid over the bounding boxes of a set of polygons
+
+    Each cell lists the polygons whose bounding box overlaps it, so point and segment queries only
+    need to test the polygons near them. Hollow polygons contain everything outside their boundary,
+    which no bounding box covers, so they are kept apart and returned by every query.
+*/
+class PolygonIndex {
+    Eigen::Vector2d _origin;
+    double _cell_size = 1.;
+    int _nx = 0, _ny = 0;
+
+    std::vector<std::vector<int>> _cells;
+    std::vector<int> _unbounded;
+
+    int column(double x) const;
+    int row(double y) const;
+
+public:
+    PolygonIndex() {}
+    PolygonIndex(const std::vector<Polygon>& polygons);
+
+    // Polygons that may contain the point, not counting the hollow polygons
+    const std::vector<int>& at(const Eigen::Vector2d& point) const;
+
+    /*  Polygons whose cells the segment from a to b passes through, in increasing order and not
+        counting the hollow polygons. Every cell the segment touches is visited, including cells it
+        only grazes at a corner.
+    */
+    std::vector<int> along(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const;
+
+    // Polygons whose cells overlap the box between lower and upper, in increasing order and not counting the hollow polygons
+    std::vector<int> within(const Eigen::Vector2d& lower, const Eigen::Vector2d& upper) const;
+
+    // Hollow polygons, to be tested by every query
+    const std::vector<int>& unbounded() const {return _unbounded;}
+
+    // Getters
+    int n_columns() const {return _nx;}
+    int n_rows() const {return _ny;}
+    double cell_size() const {return _cell_size;}
+};
+
+typedef Eigen::Matrix<double, Eigen::Dynamic, 4> MatrixX4d;
+
+/*  Batch forms of inside_any_polygon and of testing segments against every polygon with
+    segment_intersects_polygon, for rows of points (x, y) and of segments (x0, y0, x1, y1)
+
+    Each query gets the index of the first polygon that contains the point or that the segment
+    intersects, or -1 if there is none. The queries go through an index built for the batch and are
+    spread over n_threads threads (all cores if n_threads < 1).
+*/
+Eigen::VectorXi inside_polygons(const Eigen::MatrixX2d& points, const std::vector<Polygon>& polygons, int n_threads = 0);
+Eigen::VectorXi segments_intersect_polygons(const MatrixX4d& segments, const std::vector<Polygon>& polygons, int n_threads = 0);
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cmath>
+#include <Eigen/Core>
+
+/*  Orientation of c relative to the line through a and b, with an exact sign
+
+    Returns:
+        >0 if c is left of the line (a, b, c are counter-clockwise)
+        =0 if the three points lie on a line
+        <0 if c is right of the line
+
+    The determinant is evaluated in floating point first, and the result is returned as is when
+    its error bound shows the sign is right (Shewchuk's filter), which is almost always. Only
+    near-degenerate configurations fall back to orient2d_exact.
+*/
+double orient2d_exact(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c);
+
+inline double orient2d(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c)
+{
+    // Bound on the relative error of the determinant, (3 + 16 e) e for unit roundoff e = 2^-53
+    const double error_bound = (3. + 16. * 0x1p-53) * 0x1p-53;
+
+    double left = (b.x() - a.x()) * (c.y() - a.y());
+    double right = (c.x() - a.x()) * (b.y() - a.y());
+    double det = left - right;
+
+    if (std::abs(det) > error_bound * (std::abs(left) + std::abs(right)))
+        return det;
+
+    // A product that rounds to zero has a difference that is exactly zero, so the other decides the sign
+    if (left == 0. || right == 0.)
+        return det;
+
+    return orient2d_exact(a, b, c);
+}
@@ -1,6 +1,83 @@
 #pragma once
 
+#include <exception>
+#include <functional>
 #include "roadmap.hpp"
+#include "sampling.hpp"
 #include "search_space.hpp"
 
-Roadmap build_prm(int n_samples, int n_batch, int k_neighbors, const SearchSpace& search_space);
\ No newline at end of file
+/* Custom exceptions for building roadmaps */
+
+struct EmptyRegionException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "Could not draw any free space samples inside the region";
+    }
+};
+
+/*  How each sample picks the roadmap nodes it tries to connect to
+
+    k_nearest uses the fixed k_neighbors. The PRM* strategies scale with the number of nodes n
+    already in the roadmap: k_nearest_star uses the k = e (1 + 1/d) log n nearest nodes, and
+    radius_star every node within r = gamma (log n / n)^(1/d), where d is the state size. A gamma <= 0
+    (the default) takes prm_star_gamma of the search space's sampling_volume, which bounds the free
+    space's volume, and throws BadParameterException for spaces without one.
+*/
+enum class ConnectionStrategy {k_nearest, k_nearest_star, radius_star};
+
+/*  Runs work that does not touch the roadmap with whatever lock the caller holds on it released,
+    which is how the Python bindings keep the GIL for changing a roadmap that Python code shares
+*/
+typedef std::function<void(const std::function<void()>& work)> ReleaseLock;
+
+/*  Builds a probabilistic roadmap over the free space of the search space
+
+    Samples are drawn n_batch at a time. The first batch is added unconnected, and n_samples counts
+    its samples plus the edges kept since, not nodes. The nearest neighbor searches and the collision
+    checks of a batch are spread over n_threads threads (all cores if n_threads < 1), and then the
+    samples are added to the roadmap in order, so the roadmap is the same for any number of threads.
+    A lazy roadmap skips the transition checks and adds every candidate edge with unknown validity,
+    to be checked by lazy_search when a path needs it. Since it keeps every candidate edge, it uses
+    up n_samples with fewer nodes than a checked roadmap; extend_prm counts nodes, so use it to
+    compare the two (as profiling/lazy_prm.py does). A seed >= 0 draws the samples from RandomStreams,
+    which makes the roadmap reproducible for search spaces that sample from a stream. The mix adds
+    Gaussian and bridge-test samples to each batch, for maps with narrow passages.
+*/
+Roadmap build_prm(int n_samples, int n_batch, int k_neighbors, const SearchSpace& search_space, int n_threads = 1,
+    ConnectionStrategy strategy = ConnectionStrategy::k_nearest, double gamma = 0., bool lazy = false, long seed = -1,
+    const SamplingMix& mix = SamplingMix{});
+
+/*  Adds n_additional sampled nodes to an existing roadmap, connected to it like build_prm does
+
+    The roadmap's nodes, edges and k-d tree are kept, so only the new nodes cost anything. Samples
+    can be restricted to the box between region_min and region_max, and with oversampling > 1 each
+    sample is the one farthest from the roadmap out of that many candidates, which fills in sparse
+    areas first. Unlike build_prm, n_additional counts nodes. Only the free space sampling and the
+    collision checks of each batch go through release, the roadmap is read and changed outside it.
+*/
+void extend_prm(Roadmap& roadmap, int n_additional, int n_batch, int k_neighbors, const SearchSpace& search_space, int n_threads = 1,
+    ConnectionStrategy strategy = ConnectionStrategy::k_nearest, double gamma = 0., bool lazy = false,
+    const Eigen::VectorXd& region_min = Eigen::VectorXd(), const Eigen::VectorXd& region_max = Eigen::VectorXd(),
+    int oversampling = 1, const ReleaseLock& release = ReleaseLock{});
+
+/*  Builds a sparse roadmap spanner (SPARS-style) that keeps only the nodes a query needs
+
+    Each free space sample q looks for the guards, the nodes already in the roadmap within
+    visibility_radius that it can reach with a valid transition. q becomes a guard if it sees no
+    guard (coverage) or sees guards in different components, which it then connects (connectivity).
+    Otherwise, for the nearest guard v and each other guard u it sees, q is added with edges to both
+    when the roadmap's shortest path from v to u is more than stretch times longer than the path
+    through q (quality). Lengths are distances in the state space rather than transition costs,
+    which need not be a metric (e.g. PolygonSpace's squared distances). Construction stops after
+    max_failures samples in a row add nothing, or max_samples samples in all. Unlike full SPARS no
+    dense roadmap is kept alongside, so the stretch is only bounded between guards that share a
+    sample, not between any two states. Throws BadParameterException for a stretch < 1.
+*/
+Roadmap build_sparse_roadmap(const SearchSpace& search_space, double visibility_radius, double stretch, int max_failures = 1000,
+    int max_samples = 100000, long seed = -1);
+
+/*  Smallest gamma for which radius_star is asymptotically optimal, given the volume of the free
+    space and the state size: 2 (1 + 1/d)^(1/d) (free_volume / unit ball volume)^(1/d)
+*/
+double prm_star_gamma(double free_volume, int state_size);
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <Eigen/Core>
+
+/*  Seedable counter-based random number generator (Philox4x32-10)
+
+    Every block of random bits is a pure function of the seed, the stream id and the position in the
+    stream, so streams are reproducible and independent of one another. Substreams derived from a
+    stream, one per batch or per thread, give the same numbers no matter which thread draws them or
+    in what order.
+*/
+class RandomStream {
+    uint64_t _seed;
+    uint64_t _stream;
+    uint64_t _counter = 0;
+
+    // Second double of the last block, waiting to be handed out
+    double _spare;
+    bool _has_spare = false;
+
+    void next_pair(double& a, double& b);
+
+public:
+    RandomStream(uint64_t seed = 0, uint64_t stream = 0) : _seed(seed), _stream(stream) {}
+
+    // Independent stream identified by this stream and the index
+    RandomStream substream(uint64_t index) const;
+
+    // Uniform doubles in [0, 1), or [from, to)
+    double uniform();
+    double uniform(double from, double to) {return from + (to - from) * uniform();}
+
+    // Standard normal doubles, by the Box-Muller transform
+    double normal();
+
+    // Fills the block row by row, with column j uniform in [lower(j), upper(j))
+    void fill_uniform(Eigen::Ref<Eigen::MatrixXd> block, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper);
+    Eigen::MatrixXd uniform_block(int rows, int cols);
+
+    // Getters
+    uint64_t get_seed() const {return _seed;}
+    uint64_t get_stream() const {return _stream;}
+};
+
+/*  Hands out a fresh substream of one seed to every draw that is not given a stream
+
+    The substreams are numbered by an atomic counter, so draws from any number of threads never
+    share generator state, and a seeded source hands out the same streams in the same order.
+*/
+class StreamSource {
+    RandomStream _root;
+    std::atomic<uint64_t> _next{0};
+
+public:
+    StreamSource(uint64_t seed = 0) : _root(seed) {}
+    StreamSource(const StreamSource& other) : _root(other._root), _next(other._next.load()) {}
+
+    StreamSource& operator=(const StreamSource& other) {
+        _root = other._root;
+        _next = other._next.load();
+        return *this;
+    }
+
+    RandomStream next() {return _root.substream(_next.fetch_add(1));}
+};
+
+// Seed from the system's entropy source, for when no seed is given
+uint64_t entropy_seed();
+
+// Philox4x32-10 block function, encrypting the counter in place with the seed as its key
+void philox4x32_10(uint32_t counter[4], uint64_t seed);
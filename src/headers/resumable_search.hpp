@@ -0,0 +1,76 @@
+#pragma once
+
+#include <exception>
+#include <queue>
+#include <vector>
+#include <Eigen/Core>
+#include "roadmap.hpp"
+
+struct RoadmapChangedException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "The roadmap has changed since the search started";
+    }
+};
+
+enum class SearchStatus {
+    in_progress,
+    found,
+    failed
+};
+
+/*  A* search on a roadmap that can be paused and resumed
+
+    Each call to step or step_for expands nodes until its budget runs out or the search ends, so a
+    search can be spread over the ticks of a control loop without threads. The heuristic comes from
+    the roadmap's landmark tables when there are any and use_landmarks is set, otherwise this is
+    Dijkstra's algorithm. The search refers to the roadmap's indexed graph and landmark tables rather
+    than copying them, since alt_search and lazy_search build one per query, so the roadmap must
+    outlive it. Changing the roadmap's nodes, edges or landmarks rebuilds those in place, so after
+    any change step, step_for and the paths throw RoadmapChangedException rather than read them.
+*/
+class ResumableSearch {
+    typedef std::pair<double, int> CostIndexPair;
+
+    const Roadmap& _roadmap;
+    long _version;
+
+    const RoadmapGraph& _graph;
+    const Eigen::MatrixXd* _landmark_distances = nullptr;
+
+    int _start;
+    int _goal;
+
+    std::vector<double> _cost_so_far;
+    std::vector<int> _back_pointer;
+    std::vector<bool> _closed;
+    std::priority_queue<CostIndexPair, std::vector<CostIndexPair>, std::greater<CostIndexPair>> _open;
+
+    SearchStatus _status = SearchStatus::in_progress;
+    int _n_expansions = 0;
+
+    // Expanded node closest to the goal in the state space, where the best partial path ends
+    int _closest;
+    double _closest_distance;
+
+    void expand_next();
+    void check_version() const;
+    Eigen::MatrixXd path_to(int v) const;
+
+public:
+    ResumableSearch(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, bool use_landmarks = true);
+
+    SearchStatus step(int max_expansions);
+    SearchStatus step_for(double microseconds);
+
+    // Path to the goal once it is found, otherwise an empty matrix
+    Eigen::MatrixXd path() const;
+
+    // Path from the start to the expanded node that is closest to the goal state
+    Eigen::MatrixXd best_partial_path() const;
+
+    // Getters
+    SearchStatus get_status() const {return _status;}
+    int get_n_expansions() const {return _n_expansions;}
+};
@@ -4,6 +4,7 @@
 #include <map>
 #include <Eigen/Core>
 #include "kd_tree.hpp"
+#include "roadmap_graph.hpp"
 
 /* Custom exceptions for the roadmap */
 
@@ -15,14 +16,40 @@ struct MissingStateRoadmapException : public std::exception
     }
 };
 
+struct MissingEdgeRoadmapException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "Given states are not connected in the Roadmap";
+    }
+};
+
+struct BadLandmarksException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "Landmark tables do not match the Roadmap";
+    }
+};
+
+/*  Whether the transition along an edge has been checked with the search space
+
+    Lazily built roadmaps add their edges as unknown and check them only when a search wants to use
+    them. Invalid edges stay in the roadmap with their cost, so the result of the check is kept and
+    can be undone, but no search will take them: the indexed graph gives them a cost of INFINITY.
+*/
+enum class EdgeValidity : char {unknown, valid, invalid};
+
 /* Roadmap Node class */
 
 class Roadmap;
+struct SearchStatistics;
 
 class RoadmapNode {
     Eigen::VectorXd _state;
     Eigen::MatrixXd _neighbors;
     Eigen::VectorXd _costs;
+    std::vector<EdgeValidity> _validity;
 
     // Setters are private
     void set_state(const Eigen::VectorXd& value) {_state = value;}
@@ -36,16 +63,19 @@ class RoadmapNode {
 
     // Give Roadmap and search algorithms access to the node's private members
     friend class Roadmap;
-    friend Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state);
+    friend class RoadmapGraph;
+    friend Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics);
 
 public:
     RoadmapNode() {};
-    RoadmapNode(const Eigen::VectorXd& state, const Eigen::MatrixXd neighbors, const Eigen::VectorXd& costs) : _state(state), _neighbors(neighbors), _costs(costs) {}
+    RoadmapNode(const Eigen::VectorXd& state, const Eigen::MatrixXd neighbors, const Eigen::VectorXd& costs, EdgeValidity validity = EdgeValidity::valid)
+        : _state(state), _neighbors(neighbors), _costs(costs), _validity(neighbors.rows(), validity) {}
 
     // Getters
     Eigen::VectorXd get_state() const {return _state;}
     Eigen::MatrixXd get_neighbors() const {return _neighbors;}
     Eigen::VectorXd get_costs() const {return _costs;}
+    std::vector<EdgeValidity> get_validity() const {return _validity;}
 };
 
 /* Roadmap class */
@@ -69,6 +99,19 @@ class Roadmap {
     int _state_size = -1;
     int _n_states = 0;
 
+    // Indexed copy of the map, rebuilt on demand after nodes are added
+    mutable RoadmapGraph _graph;
+    mutable bool _graph_current = false;
+
+    // Landmark node indices and a (n_landmarks x n_states) table of the cost from each landmark to
+    // every node, cleared whenever the roadmap changes
+    std::vector<int> _landmarks;
+    Eigen::MatrixXd _landmark_distances;
+
+    // Counts the changes to the nodes, edges and landmark tables, so searches holding on to the
+    // indexed graph can tell that it has changed under them
+    long _version = 0;
+
     // Setters are private
     void set_state_size(int value) {_state_size = value;}
     void increment_n_states() {_n_states++;}
@@ -77,7 +120,8 @@ class Roadmap {
     const RoadmapNode& ref_node_at(const Eigen::VectorXd& state) const;
 
     // Give search functions special access to get references for speed
-    friend Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state);
+    friend class RoadmapGraph;
+    friend Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics);
 
 public:
     Roadmap() {
@@ -90,7 +134,15 @@ public:
         set_state_size(state_size);
     };
 
-    void add_node(const Eigen::VectorXd& state, const Eigen::MatrixXd& neighborStates, const Eigen::VectorXd& neighborCosts);
+    void add_node(const Eigen::VectorXd& state, const Eigen::MatrixXd& neighborStates, const Eigen::VectorXd& neighborCosts,
+        EdgeValidity validity = EdgeValidity::valid);
+
+    /*  Records the result of checking the edge between two states, in both directions and in the
+        indexed graph. Marking an edge invalid only makes the landmark tables looser, so they are
+        kept, but marking one valid again may make them wrong, so they are then discarded.
+    */
+    void set_edge_validity(const Eigen::VectorXd& a, const Eigen::VectorXd& b, EdgeValidity validity);
+    EdgeValidity edge_validity(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
 
     RoadmapNode node_at(const Eigen::VectorXd& state) const;
     RoadmapNode node_nearest(const Eigen::VectorXd& state) const;
@@ -98,12 +150,29 @@ public:
 
     Eigen::VectorXd state_nearest(const Eigen::VectorXd& state) const;
     Eigen::MatrixXd k_states_nearest(const Eigen::VectorXd& state, int k) const;
+    Eigen::MatrixXd states_within(const Eigen::VectorXd& state, double radius) const;
+
+    /*  Picks landmarks by farthest-point selection and tabulates the cost from each landmark to
+        every node, so that searches can use the triangle inequality for lower bounds on the cost
+        to go. Adding nodes to the roadmap afterwards discards the tables.
+    */
+    void preprocess_landmarks(int n_landmarks);
+    void set_landmarks(const Eigen::MatrixXd& landmark_states, const Eigen::MatrixXd& landmark_distances);
+
+    // Connected component of each state, in the order of get_states, ignoring invalid edges
+    Eigen::VectorXi get_component_labels() const;
+    int count_components() const;
 
     // Getters
     int get_state_size() const {return _state_size;}
     int get_n_states() const {return _n_states;}
+    int get_n_landmarks() const {return _landmarks.size();}
+    long get_version() const {return _version;}
     std::vector<RoadmapNode> get_nodes() const;
     Eigen::MatrixXd get_states() const;
+    Eigen::MatrixXd get_landmarks() const;
+    const Eigen::MatrixXd& get_landmark_distances() const {return _landmark_distances;}
+    const RoadmapGraph& get_graph() const;
 };
 
 Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state);
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+
+class Roadmap;
+enum class EdgeValidity : char;
+
+/*  Compact adjacency view of a Roadmap
+
+    Nodes are numbered in the same order that Roadmap::get_states returns them (lexicographic order
+    of the states), and the neighbors of node i are targets()[offsets()[i]] up to, but not including,
+    targets()[offsets()[i + 1]], with the matching transition costs in costs(). Edges marked invalid
+    cost INFINITY here, so the searches over the graph never take them.
+*/
+class RoadmapGraph {
+    Eigen::MatrixXd _states;
+    std::vector<int> _offsets;
+    std::vector<int> _targets;
+    std::vector<double> _costs;
+    std::vector<EdgeValidity> _validity;
+
+    // Roadmap keeps its cached graph in step when edges are checked
+    void set_edge_validity(int u, int w, EdgeValidity validity, double cost);
+    friend class Roadmap;
+
+public:
+    RoadmapGraph() {_offsets.push_back(0);}
+    RoadmapGraph(const Roadmap& roadmap);
+
+    int index_of(const Eigen::VectorXd& state) const;
+
+    Eigen::MatrixXd path_states(const std::vector<int>& path) const;
+
+    // Getters
+    int n_nodes() const {return _states.rows();}
+    int n_edges() const {return _targets.size();}
+    Eigen::VectorXd state(int i) const {return _states.row(i);}
+    const Eigen::MatrixXd& states() const {return _states;}
+    const std::vector<int>& offsets() const {return _offsets;}
+    const std::vector<int>& targets() const {return _targets;}
+    const std::vector<double>& costs() const {return _costs;}
+    const std::vector<EdgeValidity>& validity() const {return _validity;}
+};
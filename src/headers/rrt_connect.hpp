@@ -0,0 +1,20 @@
+#pragma once
+
+#include <Eigen/Core>
+#include "search_roadmap.hpp"
+#include "search_space.hpp"
+
+/*  Bidirectional RRT-Connect for single queries, without building a roadmap
+
+    Grows one tree from the start and one from the goal. Each iteration extends one tree by a step
+    of at most step_size towards a sample (or, with probability goal_bias, towards the other tree's
+    root), then greedily connects the other tree to the new state, and the trees swap roles. Steps
+    follow SearchSpace::interpolate and are checked with SearchSpace::valid_transition.
+
+    Returns the same path matrix as dijkstra, from the start state to the goal state, or an empty
+    matrix if the trees have not met after max_iterations, or after max_seconds if that is > 0. The
+    path is not smoothed or optimal. n_expansions counts the states added to the trees. Throws a
+    BadParameterException if step_size <= 0 or goal_bias is outside [0, 1].
+*/
+Eigen::MatrixXd rrt_connect(const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, double step_size, double goal_bias = 0.05, int max_iterations = 10000, double max_seconds = 0., long seed = -1);
+Eigen::MatrixXd rrt_connect(const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, double step_size, double goal_bias, int max_iterations, double max_seconds, long seed, SearchStatistics& statistics);
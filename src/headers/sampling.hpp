@@ -0,0 +1,35 @@
+#pragma once
+
+#include <Eigen/Core>
+#include "random_stream.hpp"
+#include "search_space.hpp"
+
+/*  Shares of each batch that build_prm draws with the narrow passage samplers
+
+    The rest of the batch is uniform free space samples. sigma is the standard deviation of the
+    offset between the two states that both samplers test, and works best at about the width of the
+    passages that need covering.
+*/
+struct SamplingMix {
+    double gaussian_ratio = 0.;
+    double bridge_ratio = 0.;
+    double sigma = 1.;
+
+    bool is_uniform() const {return gaussian_ratio <= 0. && bridge_ratio <= 0.;}
+};
+
+/*  Gaussian sampling: draws a state anywhere in the space and another at a normal offset from it,
+    and keeps the free one when exactly one of them is free, which places samples near obstacles
+
+    Both samplers need SearchSpace::valid_state, and throw NoStateCheckException on search spaces
+    that do not override it. They throw BadParameterException unless sigma > 0.
+*/
+Eigen::MatrixXd sample_gaussian(const SearchSpace& search_space, int n, double sigma, RandomStream& stream);
+
+/*  Bridge test: draws two states in collision at a normal offset from each other, and keeps their
+    midpoint when it is free, which places samples inside narrow passages
+*/
+Eigen::MatrixXd sample_bridge(const SearchSpace& search_space, int n, double sigma, RandomStream& stream);
+
+// Uniform free space samples followed by the mix's share of Gaussian and bridge samples
+Eigen::MatrixXd sample_mixed(const SearchSpace& search_space, int n, const SamplingMix& mix, RandomStream& stream);
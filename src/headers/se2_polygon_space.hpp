@@ -0,0 +1,89 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+#include <Eigen/Core>
+#include "geometry.hpp"
+#include "polygon_index.hpp"
+#include "random_stream.hpp"
+#include "search_space.hpp"
+
+struct BadFootprintException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "A robot footprint has to be a solid polygon, with its vertices counter-clockwise";
+    }
+};
+
+/*  Search space of the poses (x, y, theta) of a rigid polygonal robot among polygon obstacles
+
+    The footprint is given in the robot's frame and placed at a pose by rotating it by theta about
+    the robot's origin and moving the origin to (x, y). A pose is in collision if the placed
+    footprint overlaps or touches an obstacle. Headings wrap around, so transitions turn the short
+    way and sampled headings are in [-pi, pi).
+
+    Transitions are checked conservatively over the whole swept footprint. No point of the
+    footprint moves further than |dx, dy| + r |dtheta| over a transition, with r the distance from
+    the robot's origin to the footprint's furthest vertex, so the footprint's clearance at a pose
+    covers the part of the transition around it that moves no point that far. The parts left over
+    are checked the same way until covered, and a transition that comes closer to an obstacle than
+    a millionth of r counts as in collision.
+
+    Transition costs are |dx, dy|^2 + (w dtheta)^2, with the rotation weight w defaulting to r.
+*/
+class SE2PolygonSpace : public SearchSpace {
+    Polygon _footprint;
+    double _radius;
+
+    std::vector<Polygon> _obstacles;
+    PolygonIndex _index;
+
+    std::pair<double, double> _xrange, _yrange;
+    double _rotation_weight;
+
+    public:
+        SE2PolygonSpace(const Polygon& footprint, const std::vector<Polygon>& obstacles, std::pair<double, double> xrange,
+            std::pair<double, double> yrange, double rotation_weight = -1., long seed = -1);
+
+        Eigen::MatrixXd sample_free_space(int n) const;
+        Eigen::MatrixXd sample_free_space(int n, RandomStream& stream) const;
+
+        Eigen::MatrixXd sample_space(int n, RandomStream& stream) const;
+
+        bool valid_state(const Eigen::VectorXd& state) const;
+
+        bool valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double sampling_volume() const {return (upper() - lower()).prod();}
+
+        // Turns the short way round, with the heading of the result in [-pi, pi)
+        Eigen::VectorXd interpolate(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double t) const;
+
+        // Vertices of the footprint placed at the pose
+        Eigen::MatrixX2d footprint_at(const Eigen::VectorXd& state) const;
+
+        /*  Distance from the footprint placed at the pose to the nearest obstacle, 0 if they overlap
+            or touch, or limit if no obstacle is that close
+        */
+        double clearance(const Eigen::VectorXd& state, double limit) const;
+
+        // Getters
+        const Polygon& get_footprint() const {return _footprint;}
+        const std::vector<Polygon>& get_obstacles() const {return _obstacles;}
+        double get_rotation_weight() const {return _rotation_weight;}
+
+    private:
+        // Obstacles whose bounding boxes come within margin of the placed footprint's, and the hollow ones
+        std::vector<int> nearby(const Eigen::MatrixX2d& placed, double margin) const;
+
+        bool collides(const Eigen::MatrixX2d& placed, const Eigen::VectorXd& state, const std::vector<int>& obstacles) const;
+
+        Eigen::Vector3d lower() const;
+        Eigen::Vector3d upper() const;
+};
+
+// Angle equivalent to theta in [-pi, pi)
+double wrap_angle(double theta);
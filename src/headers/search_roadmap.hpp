@@ -0,0 +1,59 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+#include "roadmap.hpp"
+#include "search_space.hpp"
+
+/* Counters filled in by the search algorithms so that their work can be compared */
+
+struct SearchStatistics {
+    int n_expansions = 0;   // Number of nodes popped from the open queue and expanded
+    int n_edge_checks = 0;  // Number of edges checked with the search space by lazy searches and RRT-Connect
+};
+
+/*  Like the searches below, dijkstra skips invalid edges but takes edges of unknown validity as
+    they are, so a path on a lazily built roadmap may go through edges that are in collision. Use
+    lazy_search on those.
+*/
+Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics);
+
+/*  A* search with the landmark (ALT) lower bounds from Roadmap::preprocess_landmarks
+
+    Returns the same path matrix as dijkstra, or an empty matrix if the goal cannot be reached. With
+    no landmark tables on the roadmap the heuristic is zero and this is Dijkstra's algorithm. Edges
+    of unknown validity are taken unchecked, as with dijkstra.
+*/
+Eigen::MatrixXd alt_search(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state);
+Eigen::MatrixXd alt_search(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics);
+
+/*  Search on a lazily built roadmap, whose edges have not all been checked with the search space
+
+    Repeatedly finds the best path with alt_search, checks the edges of unknown validity along it
+    in one batch and marks them in the roadmap, until a path with only valid edges is found or the
+    goal cannot be reached. The checks are kept in the roadmap, so later searches reuse them.
+*/
+Eigen::MatrixXd lazy_search(Roadmap& roadmap, const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state);
+Eigen::MatrixXd lazy_search(Roadmap& roadmap, const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics);
+
+/*  Lower bound on the cost between nodes v and t from a (n_landmarks x n_nodes) landmark table, or
+    INFINITY if the table proves they are not connected
+*/
+double landmark_bound(const Eigen::MatrixXd& landmark_distances, int v, int t);
+
+/* Costs of the shortest paths from the source node to every node of the graph (INFINITY if unreachable) */
+std::vector<double> shortest_path_costs(const RoadmapGraph& graph, int source);
+
+/*  Parallel delta-stepping single-source shortest paths
+
+    Nodes are kept in buckets of width delta; each bucket's light edges (cost <= delta) are relaxed
+    in parallel until the bucket stays empty, then its heavy edges once. The costs are identical to
+    Dijkstra's. A delta <= 0 is tuned from the edge costs, and n_threads < 1 uses every core. Only
+    the buckets in use are stored, so any delta works, though a very small one leaves about one
+    node per bucket and is slow.
+*/
+std::vector<double> delta_stepping_costs(const RoadmapGraph& graph, int source, double delta, int n_threads);
+
+/* Shortest path costs from the source state to every state, in the order of Roadmap::get_states */
+Eigen::VectorXd delta_stepping(const Roadmap& roadmap, const Eigen::VectorXd& source_state, int n_threads = 0, double delta = 0.);
+Eigen::VectorXd dijkstra_costs(const Roadmap& roadmap, const Eigen::VectorXd& source_state);
@@ -1,13 +1,51 @@
 #pragma once
 
-#include <random>
+#include <vector>
 #include <Eigen/Core>
+#include "exceptions.hpp"
+#include "free_space_raster.hpp"
 #include "geometry.hpp"
+#include "low_discrepancy.hpp"
+#include "polygon_index.hpp"
+#include "random_stream.hpp"
 
+typedef Eigen::Matrix<bool, Eigen::Dynamic, 1> VectorXb;
+
+/* Custom exceptions for search spaces */
+
+struct NoFreeSpaceException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "Could not draw a sample in the free space, which may be empty";
+    }
+};
+
+struct NoStateCheckException : public std::exception
+{
+    const char* what() const throw()
+    {
+        return "The search space does not override valid_state, which the narrow passage samplers need";
+    }
+};
+
+// Draws, or rounds of redraws, after which sampling gives up on finding free space
+const int MAX_FREE_SPACE_DRAWS = 1000000;
+
+/* Where search spaces draw their candidate samples from before rejecting the ones in collision */
+
+enum class SamplingMode {uniform, halton};
 
 class SearchSpace {
     int _state_size;
 
+    SamplingMode _sampling_mode = SamplingMode::uniform;
+    // Advanced by every draw in halton mode, which is safe from several threads
+    mutable HaltonSequence _halton;
+
+    // Streams for the draws made without one, seeded by the subclasses that take a seed
+    mutable StreamSource _streams;
+
     public:
         SearchSpace() {}
 
@@ -19,6 +57,27 @@ class SearchSpace {
             return {1, 1};
         }
 
+        /*  Samples drawn from the given stream, so they are reproducible. Search spaces that do not
+            override this ignore the stream and use their own generator.
+        */
+        virtual Eigen::MatrixXd sample_free_space(int n, RandomStream& stream) const {
+            return sample_free_space(n);
+        }
+
+        /*  Samples from the whole space, obstacles included, for samplers that look for the
+            boundaries of the free space. Defaults to free space samples for spaces without bounds.
+        */
+        virtual Eigen::MatrixXd sample_space(int n, RandomStream& stream) const {
+            return sample_free_space(n, stream);
+        }
+
+        /*  Whether a single state is in the free space. Search spaces that cannot tell throw, so that
+            samplers looking for the boundaries of the free space fail rather than search forever.
+        */
+        virtual bool valid_state(const Eigen::VectorXd& state) const {
+            throw NoStateCheckException{};
+        }
+
         virtual bool valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const {
             return true;
         }
@@ -27,57 +86,176 @@ class SearchSpace {
             return 0.;
         }
 
+        /*  State a fraction t of the way along the transition from a to b, which tree planners step
+            along. Defaults to a straight line, for spaces without e.g. angles that wrap around.
+        */
+        virtual Eigen::VectorXd interpolate(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double t) const {
+            return a + t * (b - a);
+        }
+
+        virtual VectorXb valid_states(const Eigen::MatrixXd& states) const {
+            VectorXb valid(states.rows());
+            for (int i = 0; i < states.rows(); i++)
+                valid(i) = valid_state(states.row(i));
+
+            return valid;
+        }
+
+        /*  Batch forms of valid_transition and transition_cost for the transitions from each row of
+            a to the same row of b. These loop over the single transition versions unless a search
+            space overrides them, e.g. with vectorized code or to make one Python call per batch.
+        */
+        virtual VectorXb valid_transitions(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b) const {
+            check_batch_sizes(a, b);
+
+            VectorXb valid(a.rows());
+            for (int i = 0; i < a.rows(); i++)
+                valid(i) = valid_transition(a.row(i), b.row(i));
+
+            return valid;
+        }
+
+        virtual Eigen::VectorXd transition_costs(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b) const {
+            check_batch_sizes(a, b);
+
+            Eigen::VectorXd costs(a.rows());
+            for (int i = 0; i < a.rows(); i++)
+                costs(i) = transition_cost(a.row(i), b.row(i));
+
+            return costs;
+        }
+
         int state_size() const {return _state_size;}
 
+        /*  Volume of the box that samples are drawn from, obstacles included, which bounds the volume
+            of the free space. 0 for spaces without bounds, which is also the default.
+        */
+        virtual double sampling_volume() const {
+            return 0.;
+        }
+
+        /*  Switches between independent uniform samples and a scrambled Halton sequence, which
+            covers the space more evenly with fewer samples. The seed picks the scrambling. Draws,
+            rejection redraws included, take consecutive runs of the one sequence and ignore their
+            stream, so the batches of a roadmap together cover the space as evenly as one long run.
+            The samples depend on the draws made since the mode was set, which restarts the sequence.
+        */
+        void set_sampling_mode(SamplingMode mode, long seed = -1) {
+            _sampling_mode = mode;
+
+            if (mode == SamplingMode::halton)
+                _halton = HaltonSequence{_state_size, seed < 0 ? entropy_seed() : (uint64_t)seed};
+        }
+
+        SamplingMode get_sampling_mode() const {return _sampling_mode;}
+
     protected:
         void set_state_size(int state_size) {_state_size = state_size;}
-};
 
+        void set_seed(long seed) {_streams = StreamSource{seed < 0 ? entropy_seed() : (uint64_t)seed};}
 
-template<typename Numeric, typename Generator = std::mt19937>
-Numeric random(Numeric from, Numeric to)
-{
-    thread_local static Generator gen(std::random_device{}());
+        // Stream of its own for a draw made without one, so concurrent draws do not share one
+        RandomStream next_stream() const {return _streams.next();}
 
-    using dist_type = typename std::conditional
-    <
-        std::is_integral<Numeric>::value
-        , std::uniform_int_distribution<Numeric>
-        , std::uniform_real_distribution<Numeric>
-    >::type;
+        // Candidate samples in the box between lower and upper, from the sampling mode's source
+        void draw_candidates(Eigen::Ref<Eigen::MatrixXd> block, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper, RandomStream& stream) const {
+            if (_sampling_mode == SamplingMode::halton)
+                _halton.fill(block, lower, upper);
+            else
+                stream.fill_uniform(block, lower, upper);
+        }
+
+        /*  Rejection sampling of the box between lower and upper, redrawing the candidates for which
+            in_collision is true, all of them at once each round
+        */
+        template<typename InCollision>
+        Eigen::MatrixXd sample_rejecting(int n, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper, RandomStream& stream, InCollision in_collision) const {
+            Eigen::MatrixXd samples(n, lower.size());
+            draw_candidates(samples, lower, upper, stream);
+
+            std::vector<int> rejected;
+            for (int i = 0; i < n; i++) {
+                if (in_collision(samples.row(i).transpose()))
+                    rejected.push_back(i);
+            }
+
+            int count = 1;
+            while (!rejected.empty() && count < MAX_FREE_SPACE_DRAWS) {
+                Eigen::MatrixXd redraws(rejected.size(), lower.size());
+                draw_candidates(redraws, lower, upper, stream);
 
-    thread_local static dist_type dist;
+                std::vector<int> still_rejected;
+                for (int j = 0; j < redraws.rows(); j++) {
+                    samples.row(rejected[j]) = redraws.row(j);
 
-    return dist(gen, typename dist_type::param_type{from, to});
-}
+                    if (in_collision(redraws.row(j).transpose()))
+                        still_rejected.push_back(rejected[j]);
+                }
+
+                rejected.swap(still_rejected);
+                count++;
+            }
+
+            if (!rejected.empty())
+                throw NoFreeSpaceException{};
+
+            return samples;
+        }
+
+        void check_batch_sizes(const Eigen::MatrixXd& a, const Eigen::MatrixXd& b) const {
+            if (a.rows() != b.rows() || a.cols() != b.cols())
+                throw BadStateSizeException{"Batches of transition start and end states do not have the same shape"};
+        }
+};
 
 
 class PolygonSpace : public SearchSpace {
     std::vector<Polygon> _polygons;
-    
-    std::pair<double, double> _xrange, _yrange;
 
-    double _sample_x() const {
-        return random<double>(_xrange.first, _xrange.second);
-    }
+    // Grid over the polygons' bounding boxes, so queries only test the polygons near them
+    PolygonIndex _index;
 
-    double _sample_y() const {
-        return random<double>(_yrange.first, _yrange.second);
-    }
+    // Occupancy raster that free space samples are drawn from, if one has been built
+    FreeSpaceRaster _raster;
+    
+    std::pair<double, double> _xrange, _yrange;
 
     public:
-        PolygonSpace(const std::vector<Polygon>& polygons, std::pair<double, double> xrange, std::pair<double, double> yrange) {
+        PolygonSpace(const std::vector<Polygon>& polygons, std::pair<double, double> xrange, std::pair<double, double> yrange, long seed = -1) {
             _polygons = polygons;
+            _index = PolygonIndex{polygons};
             
             _xrange = xrange;
             _yrange = yrange;
 
+            set_seed(seed);
             set_state_size(2);
         }
 
         Eigen::MatrixXd sample_free_space(int n) const;
+        Eigen::MatrixXd sample_free_space(int n, RandomStream& stream) const;
+
+        Eigen::MatrixXd sample_space(int n, RandomStream& stream) const;
+
+        bool valid_state(const Eigen::VectorXd& state) const;
 
         bool valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
 
         double transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const;
+
+        double sampling_volume() const {
+            return (_xrange.second - _xrange.first) * (_yrange.second - _yrange.first);
+        }
+
+        /*  Builds an occupancy raster with resolution cells along the longer side of the map, which
+            sample_free_space then draws from instead of rejection sampling the whole map. The
+            samples are still exactly uniform over the free space. A resolution < 1 removes the
+            raster. The raster ignores the sampling mode.
+        */
+        void set_free_space_raster(int resolution);
+
+        const FreeSpaceRaster& get_free_space_raster() const {return _raster;}
+
+    private:
+        bool inside_obstacle(const Eigen::Vector2d& point) const;
 };
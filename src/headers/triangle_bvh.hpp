@@ -0,0 +1,74 @@
+#pragma once
+
+#include <vector>
+#include <Eigen/Core>
+#include "mesh_geometry.hpp"
+
+/*  Bounding volume hierarchy over a set of triangles
+
+    Nodes are split with the surface area heuristic, evaluated over bins of the triangles'
+    centroids along each axis, into leaves of a few triangles each. Nodes are stored depth first,
+    so the first child of a node is the next node.
+*/
+class TriangleBVH {
+    struct Node {
+        Eigen::Vector3d lower, upper;
+        int first = 0;      // Second child of an inner node, or the first triangle of a leaf
+        int count = 0;      // Number of triangles of a leaf, 0 for inner nodes
+    };
+
+    std::vector<Node> _nodes;
+    std::vector<int> _order;    // Triangle indices in leaf order
+    int _depth = 0;
+
+    int build(const std::vector<Eigen::Vector3d>& lower, const std::vector<Eigen::Vector3d>& upper,
+        const std::vector<Eigen::Vector3d>& centroids, int begin, int end, int depth);
+
+public:
+    // Deepest the hierarchy is built, which bounds the traversal stack
+    static const int MAX_DEPTH = 60;
+
+    TriangleBVH() {}
+    TriangleBVH(const std::vector<Triangle>& triangles);
+
+    /*  Calls visit(i) for the triangles in every leaf the ray passes through, stopping as soon as
+        visit returns true. Returns whether it stopped early.
+    */
+    template<typename Visit>
+    bool traverse(const Ray& ray, Visit visit) const {
+        if (_nodes.empty())
+            return false;
+
+        int stack[MAX_DEPTH + 1];
+        int size = 0;
+        stack[size++] = 0;
+
+        while (size > 0) {
+            const Node& node = _nodes[stack[--size]];
+            if (!ray.hits_box(node.lower, node.upper))
+                continue;
+
+            if (node.count > 0) {
+                for (int k = node.first; k < node.first + node.count; k++) {
+                    if (visit(_order[k]))
+                        return true;
+                }
+                continue;
+            }
+
+            int first_child = &node - _nodes.data() + 1;
+            stack[size++] = node.first;
+            stack[size++] = first_child;
+        }
+
+        return false;
+    }
+
+    // Corners of the box around every triangle
+    Eigen::Vector3d lower() const {return _nodes.empty() ? Eigen::Vector3d::Zero() : _nodes[0].lower;}
+    Eigen::Vector3d upper() const {return _nodes.empty() ? Eigen::Vector3d::Zero() : _nodes[0].upper;}
+
+    // Getters
+    int n_nodes() const {return _nodes.size();}
+    int depth() const {return _depth;}
+};
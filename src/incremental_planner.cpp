@@ -0,0 +1,185 @@
+#include <algorithm>
+#include <cmath>
+#include "incremental_planner.hpp"
+
+
+IncrementalPlanner::IncrementalPlanner(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state)
+    : _graph(roadmap.get_graph()), _landmark_distances(roadmap.get_landmark_distances())
+{
+    _costs = _graph.costs();
+
+    _start = _graph.index_of(start_state);
+    _goal = _graph.index_of(goal_state);
+
+    reset();
+}
+
+void IncrementalPlanner::reset()
+{
+    _g.assign(_graph.n_nodes(), INFINITY);
+    _rhs.assign(_graph.n_nodes(), INFINITY);
+    _open = {};
+
+    _rhs[_start] = 0.;
+    _open.push({calculate_key(_start), _start});
+}
+
+/*  Landmark bounds are often exact along the path, and rounding can then push the key of a node
+    on the old path just past the goal's so its repair is skipped. Shrinking the bound a little keeps
+    it consistent and leaves a margin much larger than the rounding error.
+*/
+double IncrementalPlanner::heuristic(int v) const
+{
+    return (1. - 1e-9) * landmark_bound(_landmark_distances, v, _goal);
+}
+
+IncrementalPlanner::Key IncrementalPlanner::calculate_key(int v) const
+{
+    double cost = std::min(_g[v], _rhs[v]);
+
+    return {cost + heuristic(v), cost};
+}
+
+// Recomputes the one-step lookahead cost of v and queues it if it became inconsistent
+void IncrementalPlanner::update_vertex(int v)
+{
+    const std::vector<int>& offsets = _graph.offsets();
+    const std::vector<int>& targets = _graph.targets();
+
+    if (v != _start) {
+        // The roadmap is undirected, so the predecessors are the neighbors
+        double best = INFINITY;
+        for (int e = offsets[v]; e < offsets[v + 1]; e++)
+            best = std::min(best, _g[targets[e]] + _costs[e]);
+
+        _rhs[v] = best;
+    }
+
+    if (_g[v] != _rhs[v])
+        _open.push({calculate_key(v), v});
+}
+
+void IncrementalPlanner::set_edge_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double cost)
+{
+    const std::vector<int>& offsets = _graph.offsets();
+    const std::vector<int>& targets = _graph.targets();
+    const std::vector<double>& original_costs = _graph.costs();
+
+    int u = _graph.index_of(a);
+    int v = _graph.index_of(b);
+
+    bool found = false;
+    bool below_original = false;
+
+    // Update both directions of the edge
+    for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+        if (targets[e] == v) {
+            found = true;
+            below_original |= cost < original_costs[e];
+            _costs[e] = cost;
+        }
+    }
+    for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+        if (targets[e] == u)
+            _costs[e] = cost;
+    }
+
+    if (!found)
+        throw MissingStateRoadmapException{};
+
+    if (below_original && _landmark_distances.size()) {
+        // The landmark bounds were computed with the original costs and may now overestimate
+        _landmark_distances.resize(0, 0);
+        reset();
+        return;
+    }
+
+    update_vertex(u);
+    update_vertex(v);
+}
+
+double IncrementalPlanner::edge_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    const std::vector<int>& offsets = _graph.offsets();
+    const std::vector<int>& targets = _graph.targets();
+
+    int u = _graph.index_of(a);
+    int v = _graph.index_of(b);
+
+    double cost = INFINITY;
+    for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+        if (targets[e] == v)
+            cost = std::min(cost, _costs[e]);
+    }
+
+    return cost;
+}
+
+Eigen::MatrixXd IncrementalPlanner::plan()
+{
+    SearchStatistics statistics;
+
+    return plan(statistics);
+}
+
+Eigen::MatrixXd IncrementalPlanner::plan(SearchStatistics& statistics)
+{
+    statistics = SearchStatistics{};
+
+    const std::vector<int>& offsets = _graph.offsets();
+    const std::vector<int>& targets = _graph.targets();
+
+    while (!_open.empty()) {
+        KeyIndexPair top = _open.top();
+        int u = top.second;
+
+        if (top.first >= calculate_key(_goal) && _g[_goal] == _rhs[_goal])
+            break;
+
+        _open.pop();
+
+        // Skip entries for nodes that became consistent or were queued again with another key
+        if (_g[u] == _rhs[u] || top.first != calculate_key(u))
+            continue;
+
+        statistics.n_expansions++;
+
+        if (_g[u] > _rhs[u]) {
+            _g[u] = _rhs[u];
+        }
+        else {
+            _g[u] = INFINITY;
+            update_vertex(u);
+        }
+
+        for (int e = offsets[u]; e < offsets[u + 1]; e++)
+            update_vertex(targets[e]);
+    }
+
+    if (std::isinf(_g[_goal]))
+        return {};
+
+    // Walk back from the goal through the neighbors that give each node its cost
+    std::vector<int> path = {_goal};
+    for (int v = _goal; v != _start;) {
+        int best = -1;
+        double best_cost = INFINITY;
+
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            double cost = _g[targets[e]] + _costs[e];
+            if (cost < best_cost) {
+                best_cost = cost;
+                best = targets[e];
+            }
+        }
+
+        if (best < 0 || (int)path.size() > _graph.n_nodes())
+            return {};
+
+        v = best;
+        path.push_back(v);
+    }
+    std::reverse(path.begin(), path.end());
+
+    return _graph.path_states(path);
+}
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 #include <exception>
 #include "kd_tree.hpp"
@@ -6,10 +7,11 @@
 
 
 using kdNode_ptr = std::shared_ptr<kdNode>;
+using IndexedState = std::pair<Eigen::VectorXd, int>;
 
 /* Algorithm Implementation */
 
-kdNode_ptr build_kdTree(std::vector<Eigen::VectorXd>::iterator begin, std::vector<Eigen::VectorXd>::iterator end, 
+kdNode_ptr build_kdTree(std::vector<IndexedState>::iterator begin, std::vector<IndexedState>::iterator end, 
     int size, int depth)
 {
     if (!std::distance(begin, end))
@@ -19,9 +21,9 @@ kdNode_ptr build_kdTree(std::vector<Eigen::VectorXd>::iterator begin, std::vecto
 
     // Sort the slice
     std::sort(begin, end, 
-        [axis](const Eigen::VectorXd& a, const Eigen::VectorXd& b) 
+        [axis](const IndexedState& a, const IndexedState& b) 
         { 
-            return a[axis] < b[axis];
+            return a.first[axis] < b.first[axis];
         });
 
     // Get the median
@@ -35,21 +37,22 @@ kdNode_ptr build_kdTree(std::vector<Eigen::VectorXd>::iterator begin, std::vecto
 
     root->left = left;
     root->right = right;
-    root->state = *(begin + median);
+    root->state = (begin + median)->first;
+    root->id = (begin + median)->second;
 
     return root;
 }
 
-kdNode_ptr build_kdTree(std::vector<Eigen::VectorXd>& states, int size)
+kdNode_ptr build_kdTree(std::vector<IndexedState>& states, int size)
 {
     // Start with the first dimension
     int axis = 0;
 
     // Sort the points
     std::sort(states.begin(), states.end(), 
-        [axis](const Eigen::VectorXd& a, const Eigen::VectorXd& b)
+        [axis](const IndexedState& a, const IndexedState& b)
         { 
-            return a[axis] < b[axis];
+            return a.first[axis] < b.first[axis];
         });
 
     // Get the median
@@ -63,12 +66,13 @@ kdNode_ptr build_kdTree(std::vector<Eigen::VectorXd>& states, int size)
 
     root->left = left;
     root->right = right;
-    root->state = *(states.begin() + median);
+    root->state = (states.begin() + median)->first;
+    root->id = (states.begin() + median)->second;
 
     return root;
 }
 
-void kdTree_append_state(const Eigen::VectorXd& state, kdNode_ptr root, int depth = 0)
+void kdTree_append_state(const Eigen::VectorXd& state, int id, kdNode_ptr root, int depth = 0)
 {
     int axis = depth % state.size();
 
@@ -76,12 +80,13 @@ void kdTree_append_state(const Eigen::VectorXd& state, kdNode_ptr root, int dept
         // Look left
         if (root->left) {
             // If there is a left node, proceed in that direction
-            kdTree_append_state(state, root->left, depth + 1);
+            kdTree_append_state(state, id, root->left, depth + 1);
         }
         else {
             // Else, this is the location for the point in the tree
             kdNode_ptr newNode = std::make_shared<kdNode>();
             newNode->state = state;
+            newNode->id = id;
             
             root->left = newNode;
         }
@@ -90,12 +95,13 @@ void kdTree_append_state(const Eigen::VectorXd& state, kdNode_ptr root, int dept
         // Look right
         if (root->right) {
             // If there is a right node, proceed in that direction
-            kdTree_append_state(state, root->right, depth + 1);
+            kdTree_append_state(state, id, root->right, depth + 1);
         }
         else {
             // Else, this is the location for the point in the tree
             kdNode_ptr newNode = std::make_shared<kdNode>();
             newNode->state = state;
+            newNode->id = id;
             
             root->right = newNode;
         }
@@ -184,14 +190,14 @@ void kdTree_nearest_neighbor(kdNode_ptr root, const Eigen::VectorXd& search_stat
     }
 }
 
-Eigen::VectorXd kdTree_nearest_neighbor(kdNode_ptr kd_tree, const Eigen::VectorXd& search_state)
+kdNode_ptr kdTree_nearest_neighbor(kdNode_ptr kd_tree, const Eigen::VectorXd& search_state)
 {
     double best_distance = std::numeric_limits<double>::max();
     kdNode_ptr best_node = nullptr;
 
     kdTree_nearest_neighbor(kd_tree, search_state, 0, best_distance, best_node);
 
-    return best_node->state;
+    return best_node;
 }
 
 struct kNearest {
@@ -289,6 +295,43 @@ Eigen::MatrixXd kdTree_k_nearest_neighbors(kdNode_ptr kd_tree, const Eigen::Vect
     return nearest.states();
 }
 
+void kdTree_radius_search(kdNode_ptr root, const Eigen::VectorXd& search_state, int depth, double square_radius,
+    std::vector<std::pair<double, kdNode_ptr>>& found)
+{
+    int axis = depth % search_state.size();
+
+    double dist = square_distance(search_state, root->state);
+
+    if (dist <= square_radius)
+        found.push_back({dist, root});
+
+    // Only cross the splitting plane if the ball around the search state reaches over it
+    double plane_distance = search_state[axis] - root->state[axis];
+
+    if (root->left && (plane_distance < 0 || plane_distance * plane_distance <= square_radius))
+        kdTree_radius_search(root->left, search_state, depth + 1, square_radius, found);
+
+    if (root->right && (plane_distance >= 0 || plane_distance * plane_distance <= square_radius))
+        kdTree_radius_search(root->right, search_state, depth + 1, square_radius, found);
+}
+
+std::vector<std::pair<double, kdNode_ptr>> kdTree_radius_search(kdNode_ptr kd_tree, const Eigen::VectorXd& search_state, double radius)
+{
+    std::vector<std::pair<double, kdNode_ptr>> found;
+
+    if (radius >= 0)
+        kdTree_radius_search(kd_tree, search_state, 0, radius * radius, found);
+
+    // Sort by distance, breaking ties by id so the order does not depend on the tree's shape
+    std::sort(found.begin(), found.end(),
+        [](const std::pair<double, kdNode_ptr>& a, const std::pair<double, kdNode_ptr>& b)
+        {
+            return a.first < b.first || (a.first == b.first && a.second->id < b.second->id);
+        });
+
+    return found;
+}
+
 /* CLASS IMPLEMENTATION */
 
 kdTree::kdTree(const std::vector<Eigen::VectorXd>& states)
@@ -296,13 +339,13 @@ kdTree::kdTree(const std::vector<Eigen::VectorXd>& states)
     state_size = states[0].size();
     n_states = states.size();
 
-    std::vector<Eigen::VectorXd> copy_states;
+    std::vector<IndexedState> copy_states;
 
-    for (auto state : states) {
-        if (state.size() != state_size) {
+    for (int i = 0; i < n_states; i++) {
+        if (states[i].size() != state_size) {
             throw VaryingStateSizeException{};
         }
-        copy_states.push_back(state);
+        copy_states.push_back({states[i], i});
     }
 
     root = build_kdTree(copy_states, state_size);
@@ -314,10 +357,10 @@ kdTree::kdTree(const Eigen::MatrixXd& states)
         state_size = states.cols();
         n_states = states.rows();
 
-        std::vector<Eigen::VectorXd> copy_states;
+        std::vector<IndexedState> copy_states;
 
         for (int i = 0; i < states.rows(); i++) {
-            copy_states.push_back(states.row(i));
+            copy_states.push_back({states.row(i), i});
         }
 
         root = build_kdTree(copy_states, state_size);
@@ -330,9 +373,9 @@ void kdTree::append_state(const Eigen::VectorXd& state)
         if (state.size() != state_size)
             throw BadStateSizeException{};
 
+        kdTree_append_state(state, n_states, root);
+
         n_states++;
-        
-        kdTree_append_state(state, root);
     }
     else {
         state_size = state.size();
@@ -340,6 +383,7 @@ void kdTree::append_state(const Eigen::VectorXd& state)
 
         root = std::make_shared<kdNode>();
         root->state = state;
+        root->id = 0;
     }
 }
 
@@ -376,7 +420,21 @@ Eigen::VectorXd kdTree::nearest_neighbor(const Eigen::VectorXd& search_state) co
             throw BadStateSizeException{};
         }
 
-        return kdTree_nearest_neighbor(root, search_state);
+        return kdTree_nearest_neighbor(root, search_state)->state;
+    }
+    else {
+        throw EmptyTreeException{};
+    }
+}
+
+int kdTree::nearest_neighbor_id(const Eigen::VectorXd& search_state) const
+{
+    if (root) {
+        if (search_state.size() != state_size) {
+            throw BadStateSizeException{};
+        }
+
+        return kdTree_nearest_neighbor(root, search_state)->id;
     }
     else {
         throw EmptyTreeException{};
@@ -397,6 +455,51 @@ Eigen::MatrixXd kdTree::k_nearest_neighbors(const Eigen::VectorXd& search_state,
     }
 }
 
+std::pair<Eigen::VectorXi, Eigen::VectorXd> kdTree::radius_search(const Eigen::VectorXd& search_state, double radius) const
+{
+    if (root) {
+        if (search_state.size() != state_size) {
+            throw BadStateSizeException{};
+        }
+
+        std::vector<std::pair<double, kdNode_ptr>> found = kdTree_radius_search(root, search_state, radius);
+
+        Eigen::VectorXi ids(found.size());
+        Eigen::VectorXd distances(found.size());
+
+        for (int i = 0; i < ids.size(); i++) {
+            ids(i) = found[i].second->id;
+            distances(i) = std::sqrt(found[i].first);
+        }
+
+        return {ids, distances};
+    }
+    else {
+        throw EmptyTreeException{};
+    }
+}
+
+Eigen::MatrixXd kdTree::states_within(const Eigen::VectorXd& search_state, double radius) const
+{
+    if (root) {
+        if (search_state.size() != state_size) {
+            throw BadStateSizeException{};
+        }
+
+        std::vector<std::pair<double, kdNode_ptr>> found = kdTree_radius_search(root, search_state, radius);
+
+        Eigen::MatrixXd states(found.size(), state_size);
+
+        for (int i = 0; i < states.rows(); i++)
+            states.row(i) = found[i].second->state;
+
+        return states;
+    }
+    else {
+        throw EmptyTreeException{};
+    }
+}
+
 int kdTree::count_states() const
 {
     if (root) {
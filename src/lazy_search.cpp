@@ -0,0 +1,63 @@
+#include <climits>
+#include <vector>
+#include "resumable_search.hpp"
+#include "search_roadmap.hpp"
+
+
+Eigen::MatrixXd lazy_search(Roadmap& roadmap, const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state)
+{
+    SearchStatistics statistics;
+
+    return lazy_search(roadmap, search_space, start_state, goal_state, statistics);
+}
+
+Eigen::MatrixXd lazy_search(Roadmap& roadmap, const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics)
+{
+    statistics = SearchStatistics{};
+
+    while (true) {
+        /*  Invalid edges have infinite costs in the graph, so the best path only uses valid and
+            unknown edges. Checking the edges changes the graph the search reads, so each round
+            builds a new search and is done with it before any edge is marked.
+        */
+        Eigen::MatrixXd path;
+        {
+            ResumableSearch search{roadmap, start_state, goal_state};
+            search.step(INT_MAX);
+            statistics.n_expansions += search.get_n_expansions();
+
+            path = search.path();
+        }
+
+        if (!path.rows())
+            return path;
+
+        std::vector<int> unknown;
+        for (int i = 0; i + 1 < path.rows(); i++) {
+            if (roadmap.edge_validity(path.row(i), path.row(i + 1)) == EdgeValidity::unknown)
+                unknown.push_back(i);
+        }
+
+        if (unknown.empty())
+            return path;
+
+        Eigen::MatrixXd from(unknown.size(), path.cols());
+        Eigen::MatrixXd to(unknown.size(), path.cols());
+        for (int j = 0; j < from.rows(); j++) {
+            from.row(j) = path.row(unknown[j]);
+            to.row(j) = path.row(unknown[j] + 1);
+        }
+
+        VectorXb valid = search_space.valid_transitions(from, to);
+        statistics.n_edge_checks += unknown.size();
+
+        bool path_valid = true;
+        for (int j = 0; j < from.rows(); j++) {
+            roadmap.set_edge_validity(from.row(j), to.row(j), valid(j) ? EdgeValidity::valid : EdgeValidity::invalid);
+            path_valid = path_valid && valid(j);
+        }
+
+        if (path_valid)
+            return path;
+    }
+}
@@ -0,0 +1,84 @@
+#include <numeric>
+#include <utility>
+#include "low_discrepancy.hpp"
+
+
+std::vector<int> first_primes(int n)
+{
+    std::vector<int> primes;
+
+    for (int candidate = 2; (int)primes.size() < n; candidate++) {
+        bool prime = true;
+        for (int p : primes) {
+            if (p * p > candidate)
+                break;
+            if (candidate % p == 0) {
+                prime = false;
+                break;
+            }
+        }
+
+        if (prime)
+            primes.push_back(candidate);
+    }
+
+    return primes;
+}
+
+double scrambled_radical_inverse(long index, int base, const std::vector<int>& permutation)
+{
+    double inverse_base = 1. / base;
+    double digit_weight = inverse_base;
+    double value = 0.;
+
+    while (index > 0) {
+        value += permutation[index % base] * digit_weight;
+        index /= base;
+        digit_weight *= inverse_base;
+    }
+
+    return value;
+}
+
+HaltonSequence::HaltonSequence(int dimension, uint64_t seed)
+{
+    _bases = first_primes(dimension);
+
+    RandomStream stream{seed};
+
+    for (int base : _bases) {
+        std::vector<int> permutation(base);
+        std::iota(permutation.begin(), permutation.end(), 0);
+
+        // Shuffle every digit but 0, so the trailing zeros of an index stay zeros
+        for (int i = base - 1; i > 1; i--) {
+            int j = 1 + (int)(stream.uniform() * i);
+            std::swap(permutation[i], permutation[j]);
+        }
+
+        _permutations.push_back(permutation);
+    }
+}
+
+void HaltonSequence::fill(Eigen::Ref<Eigen::MatrixXd> block, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper)
+{
+    fill(block, lower, upper, _index.fetch_add(block.rows()));
+}
+
+void HaltonSequence::fill(Eigen::Ref<Eigen::MatrixXd> block, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper, long start) const
+{
+    for (int i = 0; i < block.rows(); i++) {
+        for (int j = 0; j < block.cols(); j++) {
+            double unit = scrambled_radical_inverse(start + i, _bases[j], _permutations[j]);
+            block(i, j) = lower(j) + (upper(j) - lower(j)) * unit;
+        }
+    }
+}
+
+Eigen::MatrixXd HaltonSequence::next(int n)
+{
+    Eigen::MatrixXd points(n, dimension());
+    fill(points, Eigen::VectorXd::Zero(dimension()), Eigen::VectorXd::Ones(dimension()));
+
+    return points;
+}
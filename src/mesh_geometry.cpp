@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include "mesh_geometry.hpp"
+
+
+// Stands in for 1 / 0 in the box test
+const double LARGE_INVERSE = 1e300;
+
+// Relative slack on the far end of the box test, which covers the rounding of the slab distances
+const double BOX_TEST_SLACK = 1. + 4. * std::numeric_limits<double>::epsilon();
+
+Ray::Ray(const Eigen::Vector3d& origin, const Eigen::Vector3d& direction, double t_max)
+    : origin(origin), direction(direction), t_max(t_max)
+{
+    direction.cwiseAbs().maxCoeff(&kz);
+    kx = (kz + 1) % 3;
+    ky = (kx + 1) % 3;
+
+    // Keeps the winding of the triangles, so the edge functions keep their signs
+    if (direction(kz) < 0.)
+        std::swap(kx, ky);
+
+    sx = direction(kx) / direction(kz);
+    sy = direction(ky) / direction(kz);
+    sz = 1. / direction(kz);
+
+    for (int i = 0; i < 3; i++)
+        inverse_direction(i) = direction(i) != 0. ? 1. / direction(i) : std::copysign(LARGE_INVERSE, direction(i));
+}
+
+bool Ray::hits_box(const Eigen::Vector3d& lower, const Eigen::Vector3d& upper) const
+{
+    Eigen::Array3d t_lower = (lower - origin).array() * inverse_direction.array();
+    Eigen::Array3d t_upper = (upper - origin).array() * inverse_direction.array();
+
+    // A ray that does not move along an axis is inside that slab all along or never, even from one of its faces
+    for (int i = 0; i < 3; i++) {
+        if (direction(i) != 0.)
+            continue;
+        if (origin(i) < lower(i) || origin(i) > upper(i))
+            return false;
+
+        t_lower(i) = -INFINITY;
+        t_upper(i) = INFINITY;
+    }
+
+    double t_near = t_lower.min(t_upper).maxCoeff();
+    double t_far = t_lower.max(t_upper).minCoeff() * BOX_TEST_SLACK;
+
+    return t_near <= t_far && t_far >= 0. && t_near <= t_max;
+}
+
+int ray_hits_triangle(const Ray& ray, const Triangle& triangle, double& t)
+{
+    Eigen::Vector3d a = triangle.a - ray.origin;
+    Eigen::Vector3d b = triangle.b - ray.origin;
+    Eigen::Vector3d c = triangle.c - ray.origin;
+
+    double ax = a(ray.kx) - ray.sx * a(ray.kz);
+    double ay = a(ray.ky) - ray.sy * a(ray.kz);
+    double bx = b(ray.kx) - ray.sx * b(ray.kz);
+    double by = b(ray.ky) - ray.sy * b(ray.kz);
+    double cx = c(ray.kx) - ray.sx * c(ray.kz);
+    double cy = c(ray.ky) - ray.sy * c(ray.kz);
+
+    // Scaled barycentric coordinates, which all have the same sign if the ray passes through the triangle
+    double u = cx * by - cy * bx;
+    double v = ax * cy - ay * cx;
+    double w = bx * ay - by * ax;
+
+    if ((u < 0. || v < 0. || w < 0.) && (u > 0. || v > 0. || w > 0.))
+        return 0;
+
+    double det = u + v + w;
+    if (det == 0.)
+        return 0;
+
+    // Distance along the ray, scaled by det, which has to be in [0, t_max]
+    double scaled_t = u * ray.sz * a(ray.kz) + v * ray.sz * b(ray.kz) + w * ray.sz * c(ray.kz);
+
+    if (det > 0. ? (scaled_t < 0. || scaled_t > ray.t_max * det) : (scaled_t > 0. || scaled_t < ray.t_max * det))
+        return 0;
+
+    t = scaled_t / det;
+
+    return u == 0. || v == 0. || w == 0. ? 2 : 1;
+}
+
+TriangleMesh::TriangleMesh(const Eigen::MatrixX3d& vertices, const Eigen::MatrixX3i& faces)
+{
+    if (faces.rows() == 0 || faces.minCoeff() < 0 || faces.maxCoeff() >= vertices.rows())
+        throw BadMeshException{};
+
+    _vertices = vertices;
+    _faces = faces;
+}
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <cmath>
+#include "mesh_space.hpp"
+
+
+/*  Directions of the rays cast for the parity test, in the order they are tried. A ray that passes
+    exactly through an edge or a vertex could count a crossing twice or not at all, so the test
+    moves on to the next direction. They are far from the axes, where mesh edges usually are.
+*/
+const Eigen::Vector3d RAY_DIRECTIONS[] = {
+    {0.4472135954999579, 0.5477225575051661, 0.7071067811865476},
+    {-0.6245004513516506, 0.3872983346207417, 0.6782329983125268},
+    {0.5196152422706632, -0.7348469228349534, 0.4358898943540673},
+    {-0.3316624790355400, -0.5567764362830022, -0.7615773105863909}
+};
+
+MeshSpace::MeshSpace(const std::vector<TriangleMesh>& meshes, std::pair<double, double> xrange, std::pair<double, double> yrange,
+    std::pair<double, double> zrange, long seed)
+{
+    _meshes = meshes;
+
+    for (int m = 0; m < (int)meshes.size(); m++) {
+        for (int i = 0; i < meshes[m].n_faces(); i++) {
+            _triangles.push_back(meshes[m].face(i));
+            _triangle_meshes.push_back(m);
+        }
+    }
+
+    _bvh = TriangleBVH{_triangles};
+
+    _xrange = xrange;
+    _yrange = yrange;
+    _zrange = zrange;
+
+    set_seed(seed);
+
+    set_state_size(3);
+}
+
+Eigen::MatrixXd MeshSpace::sample_free_space(int n) const
+{
+    RandomStream stream = next_stream();
+    return sample_free_space(n, stream);
+}
+
+Eigen::MatrixXd MeshSpace::sample_free_space(int n, RandomStream& stream) const
+{
+    return sample_rejecting(n, lower(), upper(), stream, [this](const Eigen::Vector3d& sample) {
+        return inside_obstacle(sample);
+    });
+}
+
+Eigen::MatrixXd MeshSpace::sample_space(int n, RandomStream& stream) const
+{
+    Eigen::MatrixXd samples(n, 3);
+    draw_candidates(samples, lower(), upper(), stream);
+
+    return samples;
+}
+
+bool MeshSpace::valid_state(const Eigen::VectorXd& state) const
+{
+    // Written so that NaNs are out of bounds
+    if (!(state(0) >= _xrange.first && state(0) <= _xrange.second && state(1) >= _yrange.first && state(1) <= _yrange.second
+        && state(2) >= _zrange.first && state(2) <= _zrange.second))
+        return false;
+
+    return !inside_obstacle(state);
+}
+
+bool MeshSpace::valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    if (!valid_state(a) || !valid_state(b))
+        return false;
+
+    if (a == b)
+        return true;
+
+    Ray segment{a, b - a, 1.};
+
+    bool touches = _bvh.traverse(segment, [&](int i) {
+        double t;
+        return ray_hits_triangle(segment, _triangles[i], t) != 0;
+    });
+
+    return !touches;
+}
+
+double MeshSpace::transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    Eigen::VectorXd ab = b - a;
+    return ab.dot(ab);
+}
+
+bool MeshSpace::inside_obstacle(const Eigen::Vector3d& point) const
+{
+    // Rays head for the nearest sides of the box around the meshes, so they cross fewer nodes on the way out
+    Eigen::Vector3d center = (_bvh.lower() + _bvh.upper()) / 2.;
+    Eigen::Array3d signs = ((point - center).array() < 0.).select(Eigen::Array3d::Constant(-1.), Eigen::Array3d::Constant(1.));
+
+    for (const Eigen::Vector3d& direction : RAY_DIRECTIONS) {
+        Ray ray{point, direction.cwiseAbs().array() * signs, INFINITY};
+
+        // Meshes crossed an odd number of times so far
+        std::vector<int> odd;
+
+        bool ambiguous = _bvh.traverse(ray, [&](int i) {
+            double t;
+            int hit = ray_hits_triangle(ray, _triangles[i], t);
+
+            if (hit == 2 || (hit == 1 && t == 0.))
+                return true;
+
+            if (hit == 1) {
+                auto found = std::find(odd.begin(), odd.end(), _triangle_meshes[i]);
+                if (found == odd.end())
+                    odd.push_back(_triangle_meshes[i]);
+                else
+                    odd.erase(found);
+            }
+            return false;
+        });
+
+        if (!ambiguous)
+            return !odd.empty();
+    }
+
+    // The point is on a surface, or every ray grazed an edge, so it counts as in collision
+    return true;
+}
@@ -0,0 +1,105 @@
+#include <algorithm>
+#include "parallel.hpp"
+
+
+int resolve_n_threads(int n_threads)
+{
+    if (n_threads > 0)
+        return n_threads;
+
+    return std::max(1, (int)std::thread::hardware_concurrency());
+}
+
+ThreadTeam::ThreadTeam(int n_threads)
+{
+    for (int i = 1; i < resolve_n_threads(n_threads); i++)
+        _workers.emplace_back(&ThreadTeam::work, this, i);
+}
+
+ThreadTeam::~ThreadTeam()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _start.notify_all();
+
+    for (std::thread& worker : _workers)
+        worker.join();
+}
+
+void ThreadTeam::run_task(int thread_index)
+{
+    try {
+        (*_task)(thread_index);
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_error)
+            _error = std::current_exception();
+    }
+}
+
+void ThreadTeam::work(int thread_index)
+{
+    long seen_generation = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _start.wait(lock, [&]() { return _stopping || _generation != seen_generation; });
+
+            if (_stopping)
+                return;
+
+            seen_generation = _generation;
+        }
+
+        run_task(thread_index);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _n_running--;
+        }
+        _finish.notify_one();
+    }
+}
+
+void ThreadTeam::run(const std::function<void(int)>& task)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _task = &task;
+        _n_running = _workers.size();
+        _error = nullptr;
+        _generation++;
+    }
+    _start.notify_all();
+
+    run_task(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _finish.wait(lock, [&]() { return _n_running == 0; });
+
+        _task = nullptr;
+        error = _error;
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadTeam::parallel_for(int n, const std::function<void(int)>& body)
+{
+    int n_threads = size();
+
+    run([&](int thread_index) {
+        int begin = (long)n * thread_index / n_threads;
+        int end = (long)n * (thread_index + 1) / n_threads;
+
+        for (int i = begin; i < end; i++)
+            body(i);
+    });
+}
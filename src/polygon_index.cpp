@@ -0,0 +1,224 @@
+#include <algorithm>
+#include <cmath>
+#include "parallel.hpp"
+#include "polygon_index.hpp"
+
+
+// Upper limit on the number of cells along each axis of the grid
+const int MAX_GRID_CELLS = 1024;
+
+// Bounding boxes and segments are padded by this share of a cell, so rounding never loses a cell
+const double CELL_PADDING = 1e-9;
+
+// Fewest queries per thread worth starting a thread for in the batch queries
+const int MIN_QUERIES_PER_THREAD = 1024;
+
+PolygonIndex::PolygonIndex(const std::vector<Polygon>& polygons)
+{
+    std::vector<int> bounded;
+    std::vector<Eigen::Vector2d> box_min, box_max;
+
+    for (int i = 0; i < (int)polygons.size(); i++) {
+        if (polygons[i].is_hollow()) {
+            _unbounded.push_back(i);
+            continue;
+        }
+
+        bounded.push_back(i);
+        box_min.push_back(polygons[i].points().colwise().minCoeff());
+        box_max.push_back(polygons[i].points().colwise().maxCoeff());
+    }
+
+    if (bounded.empty())
+        return;
+
+    int n_bounded = bounded.size();
+
+    Eigen::Vector2d lower = box_min[0], upper = box_max[0];
+    double mean_extent = 0.;
+    for (int k = 0; k < n_bounded; k++) {
+        lower = lower.cwiseMin(box_min[k]);
+        upper = upper.cwiseMax(box_max[k]);
+        mean_extent += (box_max[k] - box_min[k]).maxCoeff() / n_bounded;
+    }
+
+    // About one polygon per cell, but no smaller than the typical polygon so each sits in few cells
+    Eigen::Vector2d extent = (upper - lower).cwiseMax(1e-12);
+    _cell_size = std::max(std::sqrt(extent.prod() / n_bounded), mean_extent);
+    _cell_size = std::max(_cell_size, extent.maxCoeff() / MAX_GRID_CELLS);
+
+    _origin = lower;
+    _nx = std::min((int)std::ceil(extent.x() / _cell_size), MAX_GRID_CELLS);
+    _ny = std::min((int)std::ceil(extent.y() / _cell_size), MAX_GRID_CELLS);
+    _nx = std::max(_nx, 1);
+    _ny = std::max(_ny, 1);
+
+    _cells.resize(_nx * _ny);
+
+    double padding = CELL_PADDING * _cell_size;
+    for (int k = 0; k < n_bounded; k++) {
+        int x0 = column(box_min[k].x() - padding), x1 = column(box_max[k].x() + padding);
+        int y0 = row(box_min[k].y() - padding), y1 = row(box_max[k].y() + padding);
+
+        for (int iy = y0; iy <= y1; iy++) {
+            for (int ix = x0; ix <= x1; ix++)
+                _cells[iy * _nx + ix].push_back(bounded[k]);
+        }
+    }
+}
+
+int PolygonIndex::column(double x) const
+{
+    double ix = std::floor((x - _origin.x()) / _cell_size);
+    return (int)std::min(std::max(ix, 0.), (double)(_nx - 1));
+}
+
+int PolygonIndex::row(double y) const
+{
+    double iy = std::floor((y - _origin.y()) / _cell_size);
+    return (int)std::min(std::max(iy, 0.), (double)(_ny - 1));
+}
+
+const std::vector<int>& PolygonIndex::at(const Eigen::Vector2d& point) const
+{
+    static const std::vector<int> none;
+
+    // Points outside the grid are outside every bounding box, and NaNs are not inside anything
+    if (_cells.empty() || !(point.x() >= _origin.x() && point.y() >= _origin.y()
+            && point.x() <= _origin.x() + _nx * _cell_size && point.y() <= _origin.y() + _ny * _cell_size))
+        return none;
+
+    return _cells[row(point.y()) * _nx + column(point.x())];
+}
+
+std::vector<int> PolygonIndex::along(const Eigen::Vector2d& a, const Eigen::Vector2d& b) const
+{
+    std::vector<int> found;
+    if (_cells.empty())
+        return found;
+
+    /*  Walk the cells along the axis the segment is longest in, and in each slice take the cells
+        the segment spans along the other axis. Keeping the slope at most 1 keeps the rounding of
+        the spans well inside the padding.
+    */
+    int major = std::abs(b.x() - a.x()) >= std::abs(b.y() - a.y()) ? 0 : 1;
+    int minor = 1 - major;
+
+    const Eigen::Vector2d& first = a(major) <= b(major) ? a : b;
+    const Eigen::Vector2d& last = a(major) <= b(major) ? b : a;
+
+    double padding = CELL_PADDING * _cell_size;
+    double length = last(major) - first(major);
+    double slope = length > 0. ? (last(minor) - first(minor)) / length : 0.;
+
+    auto index = [&](int axis, double value) {return axis == 0 ? column(value) : row(value);};
+    int n_major = major == 0 ? _nx : _ny;
+
+    int i0 = index(major, first(major) - padding), i1 = index(major, last(major) + padding);
+    for (int i = i0; i <= i1; i++) {
+        // Slices at the edges of the grid reach out to the segment's ends beyond it
+        double from = i == 0 ? first(major) : std::max(first(major), _origin(major) + i * _cell_size);
+        double to = i == n_major - 1 ? last(major) : std::min(last(major), _origin(major) + (i + 1) * _cell_size);
+
+        double minor_from = first(minor) + slope * (from - first(major));
+        double minor_to = first(minor) + slope * (to - first(major));
+
+        int j0 = index(minor, std::min(minor_from, minor_to) - padding);
+        int j1 = index(minor, std::max(minor_from, minor_to) + padding);
+
+        for (int j = j0; j <= j1; j++) {
+            const std::vector<int>& cell = major == 0 ? _cells[j * _nx + i] : _cells[i * _nx + j];
+            found.insert(found.end(), cell.begin(), cell.end());
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    return found;
+}
+
+std::vector<int> PolygonIndex::within(const Eigen::Vector2d& lower, const Eigen::Vector2d& upper) const
+{
+    std::vector<int> found;
+    if (_cells.empty())
+        return found;
+
+    double padding = CELL_PADDING * _cell_size;
+    int x0 = column(lower.x() - padding), x1 = column(upper.x() + padding);
+    int y0 = row(lower.y() - padding), y1 = row(upper.y() + padding);
+
+    for (int iy = y0; iy <= y1; iy++) {
+        for (int ix = x0; ix <= x1; ix++) {
+            const std::vector<int>& cell = _cells[iy * _nx + ix];
+            found.insert(found.end(), cell.begin(), cell.end());
+        }
+    }
+
+    std::sort(found.begin(), found.end());
+    found.erase(std::unique(found.begin(), found.end()), found.end());
+
+    return found;
+}
+
+// First of the candidates, given in increasing order, that hits, or -1
+template<typename Hits>
+int first_hit(const std::vector<int>& bounded, const std::vector<int>& unbounded, Hits hits)
+{
+    int first = -1;
+    for (int i : bounded) {
+        if (hits(i)) {
+            first = i;
+            break;
+        }
+    }
+
+    for (int i : unbounded) {
+        if (first >= 0 && i > first)
+            break;
+        if (hits(i))
+            return i;
+    }
+
+    return first;
+}
+
+// Runs query(i) for every row of a batch of n queries, spread over the threads
+template<typename Query>
+Eigen::VectorXi run_batch(int n, int n_threads, Query query)
+{
+    Eigen::VectorXi results(n);
+
+    int max_threads = std::max(n / MIN_QUERIES_PER_THREAD, 1);
+    ThreadTeam team{std::min(resolve_n_threads(n_threads), max_threads)};
+
+    team.parallel_for(n, [&](int i) { results(i) = query(i); });
+
+    return results;
+}
+
+Eigen::VectorXi inside_polygons(const Eigen::MatrixX2d& points, const std::vector<Polygon>& polygons, int n_threads)
+{
+    PolygonIndex index{polygons};
+
+    return run_batch(points.rows(), n_threads, [&](int i) {
+        Eigen::Vector2d point = points.row(i);
+
+        return first_hit(index.at(point), index.unbounded(), [&](int j) {
+            return inside_polygon(point, polygons[j]);
+        });
+    });
+}
+
+Eigen::VectorXi segments_intersect_polygons(const MatrixX4d& segments, const std::vector<Polygon>& polygons, int n_threads)
+{
+    PolygonIndex index{polygons};
+
+    return run_batch(segments.rows(), n_threads, [&](int i) {
+        std::pair<Eigen::Vector2d, Eigen::Vector2d> segment{segments.row(i).head<2>(), segments.row(i).tail<2>()};
+
+        return first_hit(index.along(segment.first, segment.second), index.unbounded(), [&](int j) {
+            return segment_intersects_polygon(segment, polygons[j]) != 0;
+        });
+    });
+}
@@ -0,0 +1,69 @@
+#include <array>
+#include "predicates.hpp"
+
+
+// Exact a + b = sum + error, where sum is the rounded sum (Knuth)
+void two_sum(double a, double b, double& sum, double& error)
+{
+    sum = a + b;
+    double b_virtual = sum - a;
+    double a_virtual = sum - b_virtual;
+    error = (a - a_virtual) + (b - b_virtual);
+}
+
+// Exact a b = product + error, where product is the rounded product
+void two_product(double a, double b, double& product, double& error)
+{
+    product = a * b;
+    error = std::fma(a, b, -product);
+}
+
+/*  Sum of the terms as a nonoverlapping expansion: components in increasing order of magnitude
+    that add up to the sum exactly, with zeros dropped (Shewchuk's grow-expansion)
+*/
+template<std::size_t N>
+int sum_expansion(const std::array<double, N>& terms, std::array<double, N>& expansion)
+{
+    int length = 0;
+
+    for (double term : terms) {
+        double carry = term;
+        int grown = 0;
+
+        for (int i = 0; i < length; i++) {
+            double error;
+            two_sum(carry, expansion[i], carry, error);
+            if (error != 0.)
+                expansion[grown++] = error;
+        }
+
+        if (carry != 0.)
+            expansion[grown++] = carry;
+
+        length = grown;
+    }
+
+    return length;
+}
+
+double orient2d_exact(const Eigen::Vector2d& a, const Eigen::Vector2d& b, const Eigen::Vector2d& c)
+{
+    // (b - a) x (c - a) expanded into six products, each of which is exactly two doubles
+    std::array<double, 12> terms;
+    two_product(b.x(), c.y(), terms[0], terms[1]);
+    two_product(-b.x(), a.y(), terms[2], terms[3]);
+    two_product(-a.x(), c.y(), terms[4], terms[5]);
+    two_product(-c.x(), b.y(), terms[6], terms[7]);
+    two_product(c.x(), a.y(), terms[8], terms[9]);
+    two_product(a.x(), b.y(), terms[10], terms[11]);
+
+    std::array<double, 12> expansion;
+    int length = sum_expansion(terms, expansion);
+
+    // The components do not overlap, so their rounded sum has the sign of the largest one
+    double estimate = 0.;
+    for (int i = 0; i < length; i++)
+        estimate += expansion[i];
+
+    return estimate;
+}
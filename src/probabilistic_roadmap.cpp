@@ -1,73 +1,337 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
 #include "probabilistic_roadmap.hpp"
+#include "parallel.hpp"
 
 
-Roadmap build_prm(int n_samples, int n_batch, int k_neighbors, const SearchSpace& search_space)
+/*  The candidate neighbors of sample i among the roadmap and the samples before it in the batch
+
+    These are the candidates that adding the batch's samples to the roadmap one at a time would have
+    found, which lets the searches for a whole batch run in parallel before any of it is added. The
+    PRM* strategies likewise count the earlier samples of the batch as roadmap nodes.
+*/
+Eigen::MatrixXd batch_candidates(const Roadmap& roadmap, const Eigen::MatrixXd& samples, int i,
+    ConnectionStrategy strategy, int k_neighbors, double gamma)
 {
-    Roadmap roadmap;    // Roadmap that we are going to produce
+    Eigen::VectorXd sample = samples.row(i);
 
-    // Get an initial sampling of the space to kick off the roadmap generation
-    Eigen::MatrixXd initial_samples = search_space.sample_free_space(n_batch);
+    double n = roadmap.get_n_states() + i;
+    double d = samples.cols();
+
+    int k = k_neighbors;
+    double radius = INFINITY;
+    Eigen::MatrixXd roadmap_nearest;
+
+    switch (strategy) {
+        case ConnectionStrategy::k_nearest:
+            roadmap_nearest = roadmap.k_states_nearest(sample, k);
+            break;
+        case ConnectionStrategy::k_nearest_star:
+            k = std::max(1, (int)std::ceil(std::exp(1.) * (1. + 1. / d) * std::log(n)));
+            roadmap_nearest = roadmap.k_states_nearest(sample, k);
+            break;
+        case ConnectionStrategy::radius_star:
+            k = std::numeric_limits<int>::max();
+            radius = gamma * std::pow(std::log(n) / n, 1. / d);
+            roadmap_nearest = roadmap.states_within(sample, radius);
+            break;
+    }
+
+    // Both lists are sorted by distance, so merge them and keep the k closest
+    std::vector<std::pair<double, int>> batch_nearest;
+    for (int j = 0; j < i; j++) {
+        double square_distance = (samples.row(j) - samples.row(i)).squaredNorm();
+        if (square_distance <= radius * radius)
+            batch_nearest.push_back({square_distance, j});
+    }
+    std::sort(batch_nearest.begin(), batch_nearest.end());
+
+    int n_nearest = (int)std::min((long)k, (long)(roadmap_nearest.rows() + batch_nearest.size()));
+    Eigen::MatrixXd nearest(n_nearest, samples.cols());
+
+    int a = 0, b = 0;
+    for (int row = 0; row < n_nearest; row++) {
+        bool take_roadmap = b == (int)batch_nearest.size() || (a < roadmap_nearest.rows() &&
+            (roadmap_nearest.row(a) - samples.row(i)).squaredNorm() <= batch_nearest[b].first);
+
+        if (take_roadmap)
+            nearest.row(row) = roadmap_nearest.row(a++);
+        else
+            nearest.row(row) = samples.row(batch_nearest[b++].second);
+    }
+
+    return nearest;
+}
+
+double prm_star_gamma(double free_volume, int state_size)
+{
+    double d = state_size;
+    double unit_ball_volume = std::pow(std::acos(-1.), d / 2.) / std::tgamma(d / 2. + 1.);
+
+    return 2. * std::pow(1. + 1. / d, 1. / d) * std::pow(free_volume / unit_ball_volume, 1. / d);
+}
+
+// The gamma radius_star uses, which for gamma <= 0 is the PRM* bound for the search space's sampling volume
+double resolve_gamma(double gamma, ConnectionStrategy strategy, const SearchSpace& search_space)
+{
+    if (gamma > 0. || strategy != ConnectionStrategy::radius_star)
+        return gamma;
+
+    double volume = search_space.sampling_volume();
+    if (!(volume > 0.))
+        throw BadParameterException{"radius_star needs a gamma > 0 for search spaces without a sampling volume"};
+
+    return prm_star_gamma(volume, search_space.state_size());
+}
+
+void run_released(const ReleaseLock& release, const std::function<void()>& work)
+{
+    if (release)
+        release(work);
+    else
+        work();
+}
+
+/*  Connects a batch of samples to the roadmap and adds them in order
+
+    Stops keeping edges once max_edges valid edges have been kept, which is how build_prm counts
+    towards its n_samples. Returns the number of edges that were kept.
+*/
+int connect_batch(Roadmap& roadmap, const Eigen::MatrixXd& samples, int k_neighbors, const SearchSpace& search_space,
+    ThreadTeam& team, ConnectionStrategy strategy, double gamma, bool lazy, int max_edges, const ReleaseLock& release)
+{
+    int n_rows = samples.rows();
+
+    // Get the candidate neighbors of every sample in the batch
+    std::vector<Eigen::MatrixXd> cand_neighbors(n_rows);
+    team.parallel_for(n_rows, [&](int i) {
+        cand_neighbors[i] = batch_candidates(roadmap, samples, i, strategy, k_neighbors, gamma);
+    });
+
+    // Lay the candidate edges of the whole batch out flat so the collision checks, which
+    // dominate the build time, are shared evenly between the threads
+    std::vector<int> edge_offsets = {0};
+    for (int i=0; i < n_rows; i++)
+        edge_offsets.push_back(edge_offsets.back() + cand_neighbors[i].rows());
+
+    std::vector<int> edge_sample(edge_offsets.back());
+    for (int i=0; i < n_rows; i++)
+        std::fill(edge_sample.begin() + edge_offsets[i], edge_sample.begin() + edge_offsets[i + 1], i);
+
+    int n_edges = edge_offsets.back();
+    std::vector<char> valid(n_edges);
+    std::vector<double> transition_costs(n_edges);
+
+    // Each thread checks one contiguous chunk of the edges with the batch interface of the
+    // search space, then costs the edges that turned out to be valid. Lazy roadmaps leave the
+    // checks to the searches and keep every edge.
+    auto check_chunk = [&](int thread) {
+        int begin = (int)((long)n_edges * thread / team.size());
+        int end = (int)((long)n_edges * (thread + 1) / team.size());
+        if (begin == end)
+            return;
+
+        Eigen::MatrixXd from(end - begin, search_space.state_size());
+        Eigen::MatrixXd to(end - begin, search_space.state_size());
+        for (int e = begin; e < end; e++) {
+            int i = edge_sample[e];
+            from.row(e - begin) = samples.row(i);
+            to.row(e - begin) = cand_neighbors[i].row(e - edge_offsets[i]);
+        }
+
+        VectorXb chunk_valid = lazy ? VectorXb::Constant(end - begin, true) : search_space.valid_transitions(from, to);
+
+        std::vector<int> valid_rows;
+        for (int row = 0; row < chunk_valid.size(); row++) {
+            valid[begin + row] = chunk_valid(row);
+            if (chunk_valid(row))
+                valid_rows.push_back(row);
+        }
+
+        int n_valid = valid_rows.size();
+        Eigen::MatrixXd valid_from(n_valid, from.cols());
+        Eigen::MatrixXd valid_to(n_valid, to.cols());
+        for (int j = 0; j < n_valid; j++) {
+            valid_from.row(j) = from.row(valid_rows[j]);
+            valid_to.row(j) = to.row(valid_rows[j]);
+        }
+
+        Eigen::VectorXd chunk_costs = search_space.transition_costs(valid_from, valid_to);
+        for (int j = 0; j < n_valid; j++)
+            transition_costs[begin + valid_rows[j]] = chunk_costs(j);
+    };
+
+    // The checks are the only part that leaves the roadmap alone
+    run_released(release, [&]() { team.run(check_chunk); });
+
+    // Commit the samples in order, so the roadmap does not depend on the number of threads
+    int edge_count = 0;
+    for (int i=0; i < n_rows; i++) {
+        // We're going to populate two containers: a container of valid neighbors out of the k
+        // neighbors we got from the nearest neighbor search and a container of the costs of
+        // transitioning to these neighbors
+        std::vector<int> valid_edges;
+        for (int e = edge_offsets[i]; e < edge_offsets[i + 1]; e++) {
+            // If we have a valid transition between the sample and candidate neighbor (no collision)...
+            if (valid[e]) {
+                // ... then keep the edge
+                valid_edges.push_back(e);
+
+                // Increment the edge count
+                edge_count++;
+
+                if (edge_count >= max_edges)
+                    break;
+            }
+        }
+
+        // Put the data into a matrix for the neighbors and a vector for the costs
+        Eigen::MatrixXd neighbors{(int)valid_edges.size(), search_space.state_size()};
+        Eigen::VectorXd costs{(int)valid_edges.size()};
 
-    for (int i=0; i < n_batch; i++) {
+        for (int j=0; j < neighbors.rows(); j++) {
+            int e = valid_edges[j];
+            neighbors.row(j) = cand_neighbors[i].row(e - edge_offsets[i]);
+            costs(j) = transition_costs[e];
+        }
+
+        // Finally, add the sample to the roadmap with its neighbors and costs
+        roadmap.add_node(samples.row(i), neighbors, costs, lazy ? EdgeValidity::unknown : EdgeValidity::valid);
+    }
+
+    return edge_count;
+}
+
+// Adds the samples to the roadmap without any edges, to give the first batch something to connect to
+void add_unconnected(Roadmap& roadmap, const Eigen::MatrixXd& samples)
+{
+    for (int i=0; i < samples.rows(); i++) {
         Eigen::MatrixXd empty_neighbors(0, 0);
         Eigen::VectorXd empty_costs(0);
 
-        roadmap.add_node(initial_samples.row(i), empty_neighbors, empty_costs);
+        roadmap.add_node(samples.row(i), empty_neighbors, empty_costs);
     }
+}
+
+Roadmap build_prm(int n_samples, int n_batch, int k_neighbors, const SearchSpace& search_space, int n_threads,
+    ConnectionStrategy strategy, double gamma, bool lazy, long seed, const SamplingMix& mix)
+{
+    Roadmap roadmap;    // Roadmap that we are going to produce
+
+    gamma = resolve_gamma(gamma, strategy, search_space);
+    ThreadTeam team{n_threads};
+
+    // With a seed, batch b is drawn from its own substream, so it does not depend on anything else
+    // that has been drawn. The narrow passage samplers always need a stream.
+    RandomStream sampling_stream{seed < 0 ? entropy_seed() : (uint64_t)seed};
+    int n_batches_drawn = 0;
+
+    auto sample_batch = [&]() {
+        if (seed < 0 && mix.is_uniform())
+            return search_space.sample_free_space(n_batch);
+
+        RandomStream batch_stream = sampling_stream.substream(n_batches_drawn++);
+        return sample_mixed(search_space, n_batch, mix, batch_stream);
+    };
+
+    // Get an initial sampling of the space to kick off the roadmap generation
+    add_unconnected(roadmap, sample_batch());
 
     // We're going to keep sampling from the free space until we have the number of nodes in the
     // roadmap that are desired.
     int node_count = n_batch;
     while (node_count < n_samples) {
-        // Sample a batch from the free space
-        Eigen::MatrixXd samples = search_space.sample_free_space(n_batch);
-
-        // Loop through the samples in the batch
-        for (int i=0; i < samples.rows(); i++) {
-            Eigen::VectorXd sample = samples.row(i);
-
-            // Get the k-nearest neighbors
-            Eigen::MatrixXd cand_neighbors = roadmap.k_states_nearest(sample, k_neighbors);
-
-            // We're going to populate two containers: a container of valid neighbors out of the k 
-            // neighbors we got from the nearest neighbor search and a container of the costs of 
-            // transitioning to these neighbors
-            std::vector<Eigen::VectorXd> valid_neighbors;
-            std::vector<double> transition_costs;
-            for (int j=0; j < cand_neighbors.rows(); j++) {
-                Eigen::VectorXd cand_neighbor = cand_neighbors.row(j);
-
-                // If we have a valid transition between the sample and candidate neighbor (no collision)...
-                if (search_space.valid_transition(sample, cand_neighbor)) {
-                    // ... then add the node's state and transition cost to their respective 
-                    // containers.
-                    valid_neighbors.push_back(cand_neighbor);
-                    transition_costs.push_back(search_space.transition_cost(sample, cand_neighbor));
-                    
-                    // Increment the node count
-                    node_count++;
-
-                    if (node_count >= n_samples)
-                        break;
-                }
-            }
+        // Sample a batch from the free space and connect it
+        Eigen::MatrixXd samples = sample_batch();
 
-            // Put the data into a matrix for the neighbors and a vector for the costs
-            int n_rows = valid_neighbors.size();
-            int n_cols = search_space.state_size();
+        node_count += connect_batch(roadmap, samples, k_neighbors, search_space, team, strategy, gamma, lazy, n_samples - node_count, ReleaseLock{});
+    }
 
-            Eigen::MatrixXd neighbors{n_rows, n_cols};
-            Eigen::VectorXd costs{n_rows};
-            
-            for (int j=0; j < n_rows; j++) {
-                neighbors.row(j) = valid_neighbors[j];
-                costs(j) = transition_costs[j];
-            }
+    return roadmap;
+}
+
+// Number of draws in a row without a single sample in the region before extend_prm gives up
+const int MAX_EMPTY_DRAWS = 100;
+
+/*  Draws n samples for extend_prm from the free space, keeping only those in the region if there is
+    one, and out of every oversampling candidates the one farthest from the roadmap's nodes
+*/
+Eigen::MatrixXd draw_extension_samples(const Roadmap& roadmap, int n, const SearchSpace& search_space, ThreadTeam& team,
+    const Eigen::VectorXd& region_min, const Eigen::VectorXd& region_max, int oversampling, const ReleaseLock& release)
+{
+    bool in_region = region_min.size() || region_max.size();
+    if (in_region && (region_min.size() != search_space.state_size() || region_max.size() != search_space.state_size()))
+        throw BadStateSizeException{"Region bounds do not have the same size as the search space's states"};
+
+    int n_candidates = n * std::max(oversampling, 1);
+
+    Eigen::MatrixXd candidates(n_candidates, search_space.state_size());
+    int n_kept = 0;
+    int n_empty_draws = 0;
 
-            // Finally, add the sample to the roadmap with its neighbors and costs
-            roadmap.add_node(sample, neighbors, costs);
+    while (n_kept < n_candidates) {
+        Eigen::MatrixXd samples;
+        run_released(release, [&]() { samples = search_space.sample_free_space(n_candidates); });
+
+        int n_kept_before = n_kept;
+        for (int i = 0; i < samples.rows() && n_kept < n_candidates; i++) {
+            if (in_region && ((samples.row(i).transpose().array() < region_min.array()).any() ||
+                              (samples.row(i).transpose().array() > region_max.array()).any()))
+                continue;
+
+            candidates.row(n_kept++) = samples.row(i);
         }
+
+        n_empty_draws = n_kept == n_kept_before ? n_empty_draws + 1 : 0;
+        if (n_empty_draws == MAX_EMPTY_DRAWS)
+            throw EmptyRegionException{};
     }
 
-    return roadmap;
-}
\ No newline at end of file
+    if (n_candidates == n || !roadmap.get_n_states())
+        return candidates.topRows(n);
+
+    // Keep the candidates that are farthest from the roadmap, in the order they were drawn
+    std::vector<double> distances(n_candidates);
+    team.parallel_for(n_candidates, [&](int i) {
+        Eigen::VectorXd candidate = candidates.row(i);
+        distances[i] = (roadmap.state_nearest(candidate) - candidate).squaredNorm();
+    });
+
+    std::vector<int> order(n_candidates);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return distances[a] > distances[b]; });
+    std::sort(order.begin(), order.begin() + n);
+
+    Eigen::MatrixXd samples(n, search_space.state_size());
+    for (int i = 0; i < n; i++)
+        samples.row(i) = candidates.row(order[i]);
+
+    return samples;
+}
+
+void extend_prm(Roadmap& roadmap, int n_additional, int n_batch, int k_neighbors, const SearchSpace& search_space, int n_threads,
+    ConnectionStrategy strategy, double gamma, bool lazy, const Eigen::VectorXd& region_min, const Eigen::VectorXd& region_max,
+    int oversampling, const ReleaseLock& release)
+{
+    if (roadmap.get_n_states() && roadmap.get_state_size() != search_space.state_size())
+        throw BadStateSizeException{"Roadmap does not have the same state size as the search space"};
+
+    gamma = resolve_gamma(gamma, strategy, search_space);
+    ThreadTeam team{n_threads};
+
+    int n_added = 0;
+    while (n_added < n_additional) {
+        int n = std::min(n_batch, n_additional - n_added);
+        Eigen::MatrixXd samples = draw_extension_samples(roadmap, n, search_space, team, region_min, region_max, oversampling, release);
+
+        // An empty roadmap gets its first batch unconnected, like build_prm
+        if (!roadmap.get_n_states())
+            add_unconnected(roadmap, samples);
+        else
+            connect_batch(roadmap, samples, k_neighbors, search_space, team, strategy, gamma, lazy, std::numeric_limits<int>::max(), release);
+
+        n_added += n;
+    }
+}
@@ -0,0 +1,136 @@
+#include <cmath>
+#include <random>
+#include "random_stream.hpp"
+
+
+/* Philox4x32-10 block function */
+
+const uint32_t PHILOX_M0 = 0xD2511F53;
+const uint32_t PHILOX_M1 = 0xCD9E8D57;
+const uint32_t PHILOX_W0 = 0x9E3779B9;
+const uint32_t PHILOX_W1 = 0xBB67AE85;
+
+void philox_round(uint32_t counter[4], const uint32_t key[2])
+{
+    uint64_t product0 = (uint64_t)PHILOX_M0 * counter[0];
+    uint64_t product1 = (uint64_t)PHILOX_M1 * counter[2];
+
+    uint32_t hi0 = product0 >> 32, lo0 = (uint32_t)product0;
+    uint32_t hi1 = product1 >> 32, lo1 = (uint32_t)product1;
+
+    counter[0] = hi1 ^ counter[1] ^ key[0];
+    counter[1] = lo1;
+    counter[2] = hi0 ^ counter[3] ^ key[1];
+    counter[3] = lo0;
+}
+
+void philox4x32_10(uint32_t counter[4], uint64_t seed)
+{
+    uint32_t key[2] = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+
+    for (int round = 0; round < 10; round++) {
+        if (round) {
+            key[0] += PHILOX_W0;
+            key[1] += PHILOX_W1;
+        }
+        philox_round(counter, key);
+    }
+}
+
+// Finalizer of splitmix64, used to spread stream ids over the whole 64 bits
+uint64_t mix64(uint64_t x)
+{
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// 53 random bits from two words, as a double in [0, 1)
+double to_unit(uint32_t a, uint32_t b)
+{
+    return ((a >> 5) * 67108864. + (b >> 6)) * (1. / 9007199254740992.);
+}
+
+/* CLASS IMPLEMENTATION */
+
+void RandomStream::next_pair(double& a, double& b)
+{
+    uint32_t block[4] = {(uint32_t)_counter, (uint32_t)(_counter >> 32), (uint32_t)_stream, (uint32_t)(_stream >> 32)};
+    _counter++;
+
+    philox4x32_10(block, _seed);
+
+    a = to_unit(block[0], block[1]);
+    b = to_unit(block[2], block[3]);
+}
+
+RandomStream RandomStream::substream(uint64_t index) const
+{
+    return RandomStream{_seed, mix64(mix64(_stream) + index + 1)};
+}
+
+double RandomStream::uniform()
+{
+    if (_has_spare) {
+        _has_spare = false;
+        return _spare;
+    }
+
+    double value;
+    next_pair(value, _spare);
+    _has_spare = true;
+
+    return value;
+}
+
+double RandomStream::normal()
+{
+    double u1 = uniform();
+    double u2 = uniform();
+
+    return std::sqrt(-2. * std::log(1. - u1)) * std::cos(2. * std::acos(-1.) * u2);
+}
+
+void RandomStream::fill_uniform(Eigen::Ref<Eigen::MatrixXd> block, const Eigen::VectorXd& lower, const Eigen::VectorXd& upper)
+{
+    int cols = block.cols();
+    int n = block.rows() * cols;
+
+    // Element k of the block in row-major order, so the values match repeated calls to uniform
+    auto set = [&](int k, double value) {
+        int j = k % cols;
+        block(k / cols, j) = lower(j) + (upper(j) - lower(j)) * value;
+    };
+
+    int k = 0;
+    if (_has_spare && n) {
+        set(k++, _spare);
+        _has_spare = false;
+    }
+
+    // Whole blocks of the generator at a time
+    for (; k + 1 < n; k += 2) {
+        double a, b;
+        next_pair(a, b);
+        set(k, a);
+        set(k + 1, b);
+    }
+
+    if (k < n)
+        set(k, uniform());
+}
+
+Eigen::MatrixXd RandomStream::uniform_block(int rows, int cols)
+{
+    Eigen::MatrixXd block(rows, cols);
+    fill_uniform(block, Eigen::VectorXd::Zero(cols), Eigen::VectorXd::Ones(cols));
+
+    return block;
+}
+
+uint64_t entropy_seed()
+{
+    std::random_device device;
+
+    return ((uint64_t)device() << 32) | device();
+}
@@ -0,0 +1,137 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "resumable_search.hpp"
+#include "search_roadmap.hpp"
+
+
+ResumableSearch::ResumableSearch(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, bool use_landmarks)
+    : _roadmap(roadmap), _version(roadmap.get_version()), _graph(roadmap.get_graph())
+{
+    if (use_landmarks && roadmap.get_n_landmarks())
+        _landmark_distances = &roadmap.get_landmark_distances();
+
+    _start = _graph.index_of(start_state);
+    _goal = _graph.index_of(goal_state);
+
+    _cost_so_far.assign(_graph.n_nodes(), INFINITY);
+    _back_pointer.assign(_graph.n_nodes(), -1);
+    _closed.assign(_graph.n_nodes(), false);
+
+    _cost_so_far[_start] = 0.;
+    _open.push({_landmark_distances ? landmark_bound(*_landmark_distances, _start, _goal) : 0., _start});
+
+    _closest = _start;
+    _closest_distance = (_graph.states().row(_start) - _graph.states().row(_goal)).norm();
+}
+
+void ResumableSearch::expand_next()
+{
+    const std::vector<int>& offsets = _graph.offsets();
+    const std::vector<int>& targets = _graph.targets();
+    const std::vector<double>& costs = _graph.costs();
+
+    // Pop until we find an entry that is not stale
+    int u = -1;
+    while (!_open.empty()) {
+        int v = _open.top().second;
+        _open.pop();
+
+        if (!_closed[v] && !std::isinf(_cost_so_far[v])) {
+            u = v;
+            break;
+        }
+    }
+
+    if (u < 0) {
+        _status = SearchStatus::failed;
+        return;
+    }
+
+    _closed[u] = true;
+    _n_expansions++;
+
+    double distance = (_graph.states().row(u) - _graph.states().row(_goal)).norm();
+    if (distance < _closest_distance) {
+        _closest = u;
+        _closest_distance = distance;
+    }
+
+    if (u == _goal) {
+        _status = SearchStatus::found;
+        return;
+    }
+
+    for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+        int v = targets[e];
+        double new_cost = _cost_so_far[u] + costs[e];
+
+        if (new_cost < _cost_so_far[v]) {
+            double bound = _landmark_distances ? landmark_bound(*_landmark_distances, v, _goal) : 0.;
+            if (std::isinf(bound))
+                continue;   // Cannot reach the goal from this neighbor
+
+            _cost_so_far[v] = new_cost;
+            _back_pointer[v] = u;
+            _closed[v] = false;
+
+            _open.push({new_cost + bound, v});
+        }
+    }
+}
+
+void ResumableSearch::check_version() const
+{
+    if (_roadmap.get_version() != _version)
+        throw RoadmapChangedException{};
+}
+
+SearchStatus ResumableSearch::step(int max_expansions)
+{
+    check_version();
+
+    for (int i = 0; i < max_expansions && _status == SearchStatus::in_progress; i++)
+        expand_next();
+
+    return _status;
+}
+
+SearchStatus ResumableSearch::step_for(double microseconds)
+{
+    // Reading the clock costs about as much as an expansion, so only check it every few expansions
+    const int expansions_per_check = 16;
+
+    check_version();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double, std::micro>(microseconds);
+
+    while (_status == SearchStatus::in_progress && std::chrono::steady_clock::now() < deadline)
+        step(expansions_per_check);
+
+    return _status;
+}
+
+Eigen::MatrixXd ResumableSearch::path_to(int v) const
+{
+    check_version();
+
+    std::vector<int> path;
+    for (; v != -1; v = _back_pointer[v])
+        path.push_back(v);
+    std::reverse(path.begin(), path.end());
+
+    return _graph.path_states(path);
+}
+
+Eigen::MatrixXd ResumableSearch::path() const
+{
+    if (_status != SearchStatus::found)
+        return {};
+
+    return path_to(_goal);
+}
+
+Eigen::MatrixXd ResumableSearch::best_partial_path() const
+{
+    return path_to(_closest);
+}
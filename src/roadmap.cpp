@@ -1,5 +1,8 @@
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include "roadmap.hpp"
+#include "search_roadmap.hpp"
 #include "exceptions.hpp"
 
 
@@ -7,7 +10,7 @@ using MatrixXd_ptr = std::unique_ptr<Eigen::MatrixXd>;
 using VectorXd_ptr = std::unique_ptr<Eigen::VectorXd>;
 
 void Roadmap::add_node(const Eigen::VectorXd& state, const Eigen::MatrixXd& neighborStates, 
-    const Eigen::VectorXd& neighborCosts)
+    const Eigen::VectorXd& neighborCosts, EdgeValidity validity)
 {
     if (get_state_size() < 0) {
         set_state_size(state.size());
@@ -67,16 +70,127 @@ void Roadmap::add_node(const Eigen::VectorXd& state, const Eigen::MatrixXd& neig
 
             node->set_neighbors(*(extended_neighbors_lists[i]));
             node->set_costs(*(extended_costs_lists[i]));
+            node->_validity.push_back(validity);
         }
     }
     // Add the node to the map
-    roadmap[state] = {state, neighborStates, neighborCosts};
+    roadmap[state] = {state, neighborStates, neighborCosts, validity};
 
     // Add the state to the k-d tree for quick searching
     kdtree.append_state(state);  
 
     // Increment the number of states in the roadmap
     increment_n_states();
+
+    // The indexed graph and landmark tables no longer describe the roadmap
+    _graph_current = false;
+    _landmarks.clear();
+    _landmark_distances.resize(0, 0);
+    _version++;
+}
+
+// Row of the neighbor in the node's neighbors, or -1 if they are not connected
+int neighbor_row(const Eigen::MatrixXd& neighbors, const Eigen::VectorXd& neighbor)
+{
+    for (int i = 0; i < neighbors.rows(); i++) {
+        if (neighbors.row(i) == neighbor.transpose())
+            return i;
+    }
+
+    return -1;
+}
+
+void Roadmap::set_edge_validity(const Eigen::VectorXd& a, const Eigen::VectorXd& b, EdgeValidity validity)
+{
+    auto it_a = roadmap.find(a);
+    auto it_b = roadmap.find(b);
+
+    if (it_a == roadmap.end() || it_b == roadmap.end())
+        throw MissingStateRoadmapException{};
+
+    RoadmapNode& node_a = it_a->second;
+    RoadmapNode& node_b = it_b->second;
+
+    int row_a = neighbor_row(node_a._neighbors, b);
+    int row_b = neighbor_row(node_b._neighbors, a);
+
+    if (row_a < 0 || row_b < 0)
+        throw MissingEdgeRoadmapException{};
+
+    bool reopened = node_a._validity[row_a] == EdgeValidity::invalid && validity != EdgeValidity::invalid;
+
+    node_a._validity[row_a] = validity;
+    node_b._validity[row_b] = validity;
+    _version++;
+
+    // Update the cached graph in place rather than rebuilding it
+    if (_graph_current) {
+        int u = _graph.index_of(a);
+        int w = _graph.index_of(b);
+
+        _graph.set_edge_validity(u, w, validity, node_a._costs(row_a));
+        _graph.set_edge_validity(w, u, validity, node_b._costs(row_b));
+    }
+
+    // An edge that can be taken again may shorten the paths the landmark tables hold
+    if (reopened) {
+        _landmarks.clear();
+        _landmark_distances.resize(0, 0);
+    }
+}
+
+EdgeValidity Roadmap::edge_validity(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    const RoadmapNode& node = ref_node_at(a);
+
+    int row = neighbor_row(node._neighbors, b);
+    if (row < 0)
+        throw MissingEdgeRoadmapException{};
+
+    return node._validity[row];
+}
+
+Eigen::VectorXi Roadmap::get_component_labels() const
+{
+    const RoadmapGraph& graph = get_graph();
+    const std::vector<int>& offsets = graph.offsets();
+    const std::vector<int>& targets = graph.targets();
+    const std::vector<double>& costs = graph.costs();
+
+    Eigen::VectorXi labels = Eigen::VectorXi::Constant(graph.n_nodes(), -1);
+
+    int n_components = 0;
+    std::vector<int> stack;
+    for (int root = 0; root < graph.n_nodes(); root++) {
+        if (labels(root) >= 0)
+            continue;
+
+        labels(root) = n_components;
+        stack.push_back(root);
+
+        while (!stack.empty()) {
+            int u = stack.back();
+            stack.pop_back();
+
+            for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+                if (labels(targets[e]) < 0 && !std::isinf(costs[e])) {
+                    labels(targets[e]) = n_components;
+                    stack.push_back(targets[e]);
+                }
+            }
+        }
+
+        n_components++;
+    }
+
+    return labels;
+}
+
+int Roadmap::count_components() const
+{
+    Eigen::VectorXi labels = get_component_labels();
+
+    return labels.size() ? labels.maxCoeff() + 1 : 0;
 }
 
 std::vector<RoadmapNode> Roadmap::get_nodes() const
@@ -152,4 +266,77 @@ Eigen::VectorXd Roadmap::state_nearest(const Eigen::VectorXd& state) const
 Eigen::MatrixXd Roadmap::k_states_nearest(const Eigen::VectorXd& state, int k) const
 {
     return kdtree.k_nearest_neighbors(state, k);
+}
+
+Eigen::MatrixXd Roadmap::states_within(const Eigen::VectorXd& state, double radius) const
+{
+    return kdtree.states_within(state, radius);
+}
+
+const RoadmapGraph& Roadmap::get_graph() const
+{
+    if (!_graph_current) {
+        _graph = RoadmapGraph(*this);
+        _graph_current = true;
+    }
+
+    return _graph;
+}
+
+void Roadmap::preprocess_landmarks(int n_landmarks)
+{
+    const RoadmapGraph& graph = get_graph();
+    int n_nodes = graph.n_nodes();
+
+    n_landmarks = std::min(n_landmarks, n_nodes);
+
+    _landmarks.clear();
+    _landmark_distances.resize(n_landmarks, n_nodes);
+    _version++;
+
+    if (!n_landmarks)
+        return;
+
+    // Farthest-point selection: start from the node farthest from an arbitrary node, then keep
+    // picking the node farthest from all the landmarks chosen so far. Unreachable nodes count as
+    // infinitely far away, so every connected component gets a landmark before any gets a second.
+    std::vector<double> from_first = shortest_path_costs(graph, 0);
+    int next = std::max_element(from_first.begin(), from_first.end()) - from_first.begin();
+
+    std::vector<double> nearest_landmark(n_nodes, INFINITY);
+
+    for (int l = 0; l < n_landmarks; l++) {
+        _landmarks.push_back(next);
+
+        std::vector<double> distances = shortest_path_costs(graph, next);
+        for (int v = 0; v < n_nodes; v++) {
+            _landmark_distances(l, v) = distances[v];
+            nearest_landmark[v] = std::min(nearest_landmark[v], distances[v]);
+        }
+
+        next = std::max_element(nearest_landmark.begin(), nearest_landmark.end()) - nearest_landmark.begin();
+    }
+}
+
+void Roadmap::set_landmarks(const Eigen::MatrixXd& landmark_states, const Eigen::MatrixXd& landmark_distances)
+{
+    const RoadmapGraph& graph = get_graph();
+
+    if (landmark_states.rows() != landmark_distances.rows() || landmark_distances.cols() != graph.n_nodes())
+        throw BadLandmarksException{};
+
+    if (landmark_states.rows() && landmark_states.cols() != get_state_size())
+        throw BadStateSizeException{"Given landmark state does not have the same size as the Roadmap's state space"};
+
+    _landmarks.clear();
+    for (int l = 0; l < landmark_states.rows(); l++)
+        _landmarks.push_back(graph.index_of(landmark_states.row(l)));
+
+    _landmark_distances = landmark_distances;
+    _version++;
+}
+
+Eigen::MatrixXd Roadmap::get_landmarks() const
+{
+    return get_graph().path_states(_landmarks);
 }
\ No newline at end of file
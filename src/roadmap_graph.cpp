@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <cmath>
+#include "roadmap_graph.hpp"
+#include "roadmap.hpp"
+
+
+bool state_less(const Eigen::MatrixXd& states, int i, const Eigen::VectorXd& state)
+{
+    for (int j = 0; j < state.size(); j++) {
+        if (states(i, j) < state(j))
+            return true;
+        if (states(i, j) > state(j))
+            return false;
+    }
+
+    return false;
+}
+
+RoadmapGraph::RoadmapGraph(const Roadmap& roadmap)
+{
+    int n_states = roadmap.get_n_states();
+
+    _states.resize(n_states, std::max(roadmap.get_state_size(), 0));
+    _offsets.reserve(n_states + 1);
+    _offsets.push_back(0);
+
+    // The roadmap's map is ordered, so the row of each state is its index
+    int i = 0;
+    for (auto it = roadmap.roadmap.begin(); it != roadmap.roadmap.end(); ++it, ++i) {
+        _states.row(i) = it->first;
+        _offsets.push_back(_offsets.back() + it->second.ref_neighbors().rows());
+    }
+
+    _targets.resize(_offsets.back());
+    _costs.resize(_offsets.back());
+    _validity.resize(_offsets.back());
+
+    i = 0;
+    for (auto it = roadmap.roadmap.begin(); it != roadmap.roadmap.end(); ++it, ++i) {
+        const Eigen::MatrixXd& neighbors = it->second.ref_neighbors();
+        const Eigen::VectorXd& costs = it->second.ref_costs();
+        const std::vector<EdgeValidity>& validity = it->second._validity;
+
+        for (int j = 0; j < neighbors.rows(); j++) {
+            _targets[_offsets[i] + j] = index_of(neighbors.row(j));
+            _costs[_offsets[i] + j] = validity[j] == EdgeValidity::invalid ? INFINITY : costs(j);
+            _validity[_offsets[i] + j] = validity[j];
+        }
+    }
+}
+
+int RoadmapGraph::index_of(const Eigen::VectorXd& state) const
+{
+    if (state.size() != _states.cols())
+        throw MissingStateRoadmapException{};
+
+    // Binary search over the lexicographically sorted states
+    int lo = 0;
+    int hi = n_nodes();
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+
+        if (state_less(_states, mid, state))
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    if (lo == n_nodes() || _states.row(lo) != state.transpose())
+        throw MissingStateRoadmapException{};
+
+    return lo;
+}
+
+void RoadmapGraph::set_edge_validity(int u, int w, EdgeValidity validity, double cost)
+{
+    for (int e = _offsets[u]; e < _offsets[u + 1]; e++) {
+        if (_targets[e] == w) {
+            _validity[e] = validity;
+            _costs[e] = validity == EdgeValidity::invalid ? INFINITY : cost;
+        }
+    }
+}
+
+Eigen::MatrixXd RoadmapGraph::path_states(const std::vector<int>& path) const
+{
+    Eigen::MatrixXd states(path.size(), _states.cols());
+
+    for (int i = 0; i < states.rows(); i++)
+        states.row(i) = _states.row(path[i]);
+
+    return states;
+}
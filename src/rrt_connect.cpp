@@ -0,0 +1,157 @@
+#include <chrono>
+#include <vector>
+#include "kd_tree.hpp"
+#include "random_stream.hpp"
+#include "rrt_connect.hpp"
+
+
+// Samples are drawn from the search space in blocks, so a Python search space is called once per block
+const int SAMPLE_BLOCK_SIZE = 64;
+
+// Reading the clock costs about as much as an iteration, so only check it every few iterations
+const int CLOCK_CHECK_INTERVAL = 16;
+
+enum class ExtendResult {trapped, advanced, reached};
+
+struct RRTree {
+    kdTree tree;
+    std::vector<Eigen::VectorXd> states;
+    std::vector<int> parents;
+
+    RRTree(const Eigen::VectorXd& root) : tree(root.transpose()) {
+        states.push_back(root);
+        parents.push_back(-1);
+    }
+
+    void add(const Eigen::VectorXd& state, int parent) {
+        tree.append_state(state);
+        states.push_back(state);
+        parents.push_back(parent);
+    }
+};
+
+/*  Steps the tree from its nearest state towards the target, by at most step_size, and sets last
+    to the state the tree reached
+*/
+ExtendResult extend(RRTree& tree, const Eigen::VectorXd& target, const SearchSpace& search_space, double step_size, SearchStatistics& statistics, int& last)
+{
+    int nearest = tree.tree.nearest_neighbor_id(target);
+    Eigen::VectorXd from = tree.states[nearest];
+
+    last = nearest;
+
+    double distance = (target - from).norm();
+    if (distance == 0.)
+        return ExtendResult::reached;
+
+    bool reaches = distance <= step_size;
+    Eigen::VectorXd to = reaches ? target : search_space.interpolate(from, target, step_size / distance);
+
+    statistics.n_edge_checks++;
+    if (!search_space.valid_transition(from, to))
+        return ExtendResult::trapped;
+
+    tree.add(to, nearest);
+    statistics.n_expansions++;
+
+    last = tree.states.size() - 1;
+
+    return reaches ? ExtendResult::reached : ExtendResult::advanced;
+}
+
+ExtendResult connect(RRTree& tree, const Eigen::VectorXd& target, const SearchSpace& search_space, double step_size, SearchStatistics& statistics, int& last)
+{
+    ExtendResult result;
+    do {
+        result = extend(tree, target, search_space, step_size, statistics, last);
+    } while (result == ExtendResult::advanced);
+
+    return result;
+}
+
+// States from the root of the tree to the given state, root first
+std::vector<Eigen::VectorXd> branch(const RRTree& tree, int v)
+{
+    std::vector<Eigen::VectorXd> states;
+    for (; v >= 0; v = tree.parents[v])
+        states.push_back(tree.states[v]);
+
+    return {states.rbegin(), states.rend()};
+}
+
+Eigen::MatrixXd rrt_connect(const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, double step_size, double goal_bias, int max_iterations, double max_seconds, long seed)
+{
+    SearchStatistics statistics;
+
+    return rrt_connect(search_space, start_state, goal_state, step_size, goal_bias, max_iterations, max_seconds, seed, statistics);
+}
+
+Eigen::MatrixXd rrt_connect(const SearchSpace& search_space, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, double step_size, double goal_bias, int max_iterations, double max_seconds, long seed, SearchStatistics& statistics)
+{
+    statistics = SearchStatistics{};
+
+    if (start_state.size() != goal_state.size())
+        throw BadStateSizeException{};
+
+    // A step of 0 would never leave the nearest state, and connect would loop forever
+    if (!(step_size > 0.))
+        throw BadParameterException{"The step size has to be > 0"};
+    if (!(goal_bias >= 0. && goal_bias <= 1.))
+        throw BadParameterException{"The goal bias has to be in [0, 1]"};
+
+    RandomStream stream{seed < 0 ? entropy_seed() : (uint64_t)seed};
+
+    RRTree start_tree{start_state};
+    RRTree goal_tree{goal_state};
+
+    // The tree being extended towards the sample and the tree being connected to the new state
+    RRTree* a = &start_tree;
+    RRTree* b = &goal_tree;
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::duration<double>(max_seconds);
+
+    Eigen::MatrixXd samples;
+    int next_sample = SAMPLE_BLOCK_SIZE;
+
+    for (int iteration = 0; iteration < max_iterations; iteration++) {
+        if (max_seconds > 0. && iteration % CLOCK_CHECK_INTERVAL == 0 && std::chrono::steady_clock::now() >= deadline)
+            break;
+
+        Eigen::VectorXd target;
+        if (stream.uniform() < goal_bias) {
+            target = b->states[0];
+        }
+        else {
+            if (next_sample == SAMPLE_BLOCK_SIZE) {
+                samples = search_space.sample_free_space(SAMPLE_BLOCK_SIZE, stream);
+                next_sample = 0;
+            }
+            target = samples.row(next_sample++);
+        }
+
+        int a_last, b_last;
+        if (extend(*a, target, search_space, step_size, statistics, a_last) != ExtendResult::trapped) {
+            if (connect(*b, a->states[a_last], search_space, step_size, statistics, b_last) == ExtendResult::reached) {
+                std::vector<Eigen::VectorXd> a_branch = branch(*a, a_last);
+                std::vector<Eigen::VectorXd> b_branch = branch(*b, b_last);
+
+                std::vector<Eigen::VectorXd>& from_start = a == &start_tree ? a_branch : b_branch;
+                std::vector<Eigen::VectorXd>& from_goal = a == &start_tree ? b_branch : a_branch;
+
+                // Both branches end at the state where the trees meet, so it is only kept once
+                Eigen::MatrixXd path(from_start.size() + from_goal.size() - 1, start_state.size());
+                int row = 0;
+                for (const Eigen::VectorXd& state : from_start)
+                    path.row(row++) = state;
+                for (int i = from_goal.size() - 2; i >= 0; i--)
+                    path.row(row++) = from_goal[i];
+
+                return path;
+            }
+        }
+
+        std::swap(a, b);
+    }
+
+    return {};
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <cmath>
+#include "sampling.hpp"
+
+
+// Rounds of candidate pairs the narrow passage samplers draw before topping up with uniform samples
+const int MAX_SAMPLING_ROUNDS = 1000;
+const int MIN_PAIRS_PER_ROUND = 64;
+
+// Written so that a NaN sigma is rejected too, as it would collapse every pair onto one state
+void check_sigma(double sigma)
+{
+    if (!(sigma > 0.))
+        throw BadParameterException{"The narrow passage samplers need a sigma > 0"};
+}
+
+Eigen::MatrixXd normal_offsets(const Eigen::MatrixXd& states, double sigma, RandomStream& stream)
+{
+    Eigen::MatrixXd offset_states(states.rows(), states.cols());
+
+    for (int i = 0; i < states.rows(); i++) {
+        for (int j = 0; j < states.cols(); j++)
+            offset_states(i, j) = states(i, j) + sigma * stream.normal();
+    }
+
+    return offset_states;
+}
+
+// Fills the rows that the sampler could not find with uniform free space samples
+void top_up(const SearchSpace& search_space, Eigen::MatrixXd& samples, int n_found, RandomStream& stream)
+{
+    if (n_found < samples.rows())
+        samples.bottomRows(samples.rows() - n_found) = search_space.sample_free_space(samples.rows() - n_found, stream);
+}
+
+Eigen::MatrixXd sample_gaussian(const SearchSpace& search_space, int n, double sigma, RandomStream& stream)
+{
+    check_sigma(sigma);
+
+    Eigen::MatrixXd samples(n, search_space.state_size());
+
+    int n_found = 0;
+    for (int round = 0; round < MAX_SAMPLING_ROUNDS && n_found < n; round++) {
+        int n_pairs = std::max(n - n_found, MIN_PAIRS_PER_ROUND);
+
+        Eigen::MatrixXd first = search_space.sample_space(n_pairs, stream);
+        Eigen::MatrixXd second = normal_offsets(first, sigma, stream);
+
+        VectorXb first_valid = search_space.valid_states(first);
+        VectorXb second_valid = search_space.valid_states(second);
+
+        for (int i = 0; i < n_pairs && n_found < n; i++) {
+            if (first_valid(i) != second_valid(i))
+                samples.row(n_found++) = first_valid(i) ? first.row(i) : second.row(i);
+        }
+    }
+
+    top_up(search_space, samples, n_found, stream);
+
+    return samples;
+}
+
+Eigen::MatrixXd sample_bridge(const SearchSpace& search_space, int n, double sigma, RandomStream& stream)
+{
+    check_sigma(sigma);
+
+    Eigen::MatrixXd samples(n, search_space.state_size());
+
+    int n_found = 0;
+    for (int round = 0; round < MAX_SAMPLING_ROUNDS && n_found < n; round++) {
+        int n_pairs = std::max(n - n_found, MIN_PAIRS_PER_ROUND);
+
+        Eigen::MatrixXd first = search_space.sample_space(n_pairs, stream);
+        Eigen::MatrixXd second = normal_offsets(first, sigma, stream);
+
+        VectorXb first_valid = search_space.valid_states(first);
+        VectorXb second_valid = search_space.valid_states(second);
+
+        // Only the midpoints of pairs with both ends in collision need checking
+        std::vector<int> bridges;
+        for (int i = 0; i < n_pairs; i++) {
+            if (!first_valid(i) && !second_valid(i))
+                bridges.push_back(i);
+        }
+
+        Eigen::MatrixXd midpoints(bridges.size(), first.cols());
+        for (int j = 0; j < midpoints.rows(); j++)
+            midpoints.row(j) = (first.row(bridges[j]) + second.row(bridges[j])) / 2.;
+
+        VectorXb midpoint_valid = search_space.valid_states(midpoints);
+
+        for (int j = 0; j < midpoints.rows() && n_found < n; j++) {
+            if (midpoint_valid(j))
+                samples.row(n_found++) = midpoints.row(j);
+        }
+    }
+
+    top_up(search_space, samples, n_found, stream);
+
+    return samples;
+}
+
+Eigen::MatrixXd sample_mixed(const SearchSpace& search_space, int n, const SamplingMix& mix, RandomStream& stream)
+{
+    int n_gaussian = std::min(n, (int)std::round(n * std::max(mix.gaussian_ratio, 0.)));
+    int n_bridge = std::min(n - n_gaussian, (int)std::round(n * std::max(mix.bridge_ratio, 0.)));
+    int n_uniform = n - n_gaussian - n_bridge;
+
+    Eigen::MatrixXd samples(n, search_space.state_size());
+
+    if (n_uniform)
+        samples.topRows(n_uniform) = search_space.sample_free_space(n_uniform, stream);
+    if (n_gaussian)
+        samples.middleRows(n_uniform, n_gaussian) = sample_gaussian(search_space, n_gaussian, mix.sigma, stream);
+    if (n_bridge)
+        samples.bottomRows(n_bridge) = sample_bridge(search_space, n_bridge, mix.sigma, stream);
+
+    return samples;
+}
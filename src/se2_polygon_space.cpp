@@ -0,0 +1,215 @@
+#define _USE_MATH_DEFINES
+#include <cmath>
+#include "se2_polygon_space.hpp"
+
+
+// Closest a transition may come to an obstacle, as a share of the footprint's radius
+const double SWEEP_TOLERANCE = 1e-6;
+
+// Most poses checked along one transition before it is given up on as in collision
+const int MAX_SWEEP_CHECKS = 10000;
+
+double wrap_angle(double theta)
+{
+    return theta - 2. * M_PI * std::floor((theta + M_PI) / (2. * M_PI));
+}
+
+SE2PolygonSpace::SE2PolygonSpace(const Polygon& footprint, const std::vector<Polygon>& obstacles, std::pair<double, double> xrange,
+    std::pair<double, double> yrange, double rotation_weight, long seed) : _footprint(footprint)
+{
+    if (!footprint.is_solid())
+        throw BadFootprintException{};
+
+    _radius = footprint.points().rowwise().norm().maxCoeff();
+
+    _obstacles = obstacles;
+    _index = PolygonIndex{obstacles};
+
+    _xrange = xrange;
+    _yrange = yrange;
+    _rotation_weight = rotation_weight < 0. ? _radius : rotation_weight;
+
+    set_seed(seed);
+
+    set_state_size(3);
+}
+
+Eigen::MatrixXd SE2PolygonSpace::sample_free_space(int n) const
+{
+    RandomStream stream = next_stream();
+    return sample_free_space(n, stream);
+}
+
+Eigen::MatrixXd SE2PolygonSpace::sample_free_space(int n, RandomStream& stream) const
+{
+    return sample_rejecting(n, lower(), upper(), stream, [this](const Eigen::VectorXd& sample) {
+        Eigen::MatrixX2d placed = footprint_at(sample);
+        return collides(placed, sample, nearby(placed, 0.));
+    });
+}
+
+Eigen::MatrixXd SE2PolygonSpace::sample_space(int n, RandomStream& stream) const
+{
+    Eigen::MatrixXd samples(n, 3);
+    draw_candidates(samples, lower(), upper(), stream);
+
+    return samples;
+}
+
+bool SE2PolygonSpace::valid_state(const Eigen::VectorXd& state) const
+{
+    // Written so that NaNs are out of bounds
+    if (!(state(0) >= _xrange.first && state(0) <= _xrange.second && state(1) >= _yrange.first && state(1) <= _yrange.second
+        && std::isfinite(state(2))))
+        return false;
+
+    Eigen::MatrixX2d placed = footprint_at(state);
+    return !collides(placed, state, nearby(placed, 0.));
+}
+
+bool SE2PolygonSpace::valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    if (!valid_state(a) || !valid_state(b))
+        return false;
+
+    // Furthest any point of the footprint moves over the transition, which moves every point at a steady pace
+    double sweep = (b.head<2>() - a.head<2>()).norm() + _radius * std::abs(wrap_angle(b(2) - a(2)));
+    if (sweep == 0.)
+        return true;
+
+    double tolerance = SWEEP_TOLERANCE * _radius;
+
+    /*  Parts of the transition, as fractions of the way along it, that are still to be covered,
+        checked coarse to fine so that collisions turn up early. The clearance at the middle of a
+        part covers every pose that moves no point of the footprint further than that.
+    */
+    std::vector<std::pair<double, double>> parts{{0., 1.}};
+
+    for (int head = 0; head < (int)parts.size(); head++) {
+        if (head == MAX_SWEEP_CHECKS)
+            return false;
+
+        double t0 = parts[head].first, t1 = parts[head].second;
+        double t = (t0 + t1) / 2.;
+        double reach = (t1 - t0) / 2. * sweep;
+
+        double gap = clearance(interpolate(a, b, t), reach);
+        if (gap >= reach)
+            continue;
+        if (gap <= tolerance)
+            return false;
+
+        // Shorter than half the part, since the clearance fell short of the reach
+        double covered = gap / sweep;
+        parts.push_back({t0, t - covered});
+        parts.push_back({t + covered, t1});
+    }
+
+    return true;
+}
+
+double SE2PolygonSpace::transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
+{
+    Eigen::Vector2d ab = b.head<2>() - a.head<2>();
+    double turn = _rotation_weight * wrap_angle(b(2) - a(2));
+
+    return ab.dot(ab) + turn * turn;
+}
+
+Eigen::VectorXd SE2PolygonSpace::interpolate(const Eigen::VectorXd& a, const Eigen::VectorXd& b, double t) const
+{
+    Eigen::VectorXd state = a + t * (b - a);
+    state(2) = wrap_angle(a(2) + t * wrap_angle(b(2) - a(2)));
+
+    return state;
+}
+
+Eigen::MatrixX2d SE2PolygonSpace::footprint_at(const Eigen::VectorXd& state) const
+{
+    double c = std::cos(state(2)), s = std::sin(state(2));
+
+    Eigen::Matrix2d rotation;
+    rotation << c, -s, s, c;
+
+    Eigen::MatrixX2d placed = _footprint.points() * rotation.transpose();
+    placed.rowwise() += state.head<2>().transpose();
+
+    return placed;
+}
+
+double SE2PolygonSpace::clearance(const Eigen::VectorXd& state, double limit) const
+{
+    Eigen::MatrixX2d placed = footprint_at(state);
+    std::vector<int> obstacles = nearby(placed, limit);
+
+    if (collides(placed, state, obstacles))
+        return 0.;
+
+    // Between shapes that do not meet, the nearest points include a vertex of one of them
+    double c = std::cos(state(2)), s = std::sin(state(2));
+    double gap = limit;
+
+    for (int i : obstacles) {
+        const Polygon& obstacle = _obstacles[i];
+
+        for (int k = 0; k < placed.rows(); k++)
+            gap = std::min(gap, distance_to_boundary(placed.row(k), obstacle));
+
+        for (int k = 0; k < obstacle.n_points(); k++) {
+            Eigen::Vector2d offset = obstacle[k] - state.head<2>();
+            Eigen::Vector2d local{c * offset.x() + s * offset.y(), -s * offset.x() + c * offset.y()};
+
+            gap = std::min(gap, distance_to_boundary(local, _footprint));
+        }
+    }
+
+    return gap;
+}
+
+std::vector<int> SE2PolygonSpace::nearby(const Eigen::MatrixX2d& placed, double margin) const
+{
+    Eigen::Vector2d padding = Eigen::Vector2d::Constant(margin);
+    std::vector<int> found = _index.within(placed.colwise().minCoeff().transpose() - padding,
+        placed.colwise().maxCoeff().transpose() + padding);
+
+    found.insert(found.end(), _index.unbounded().begin(), _index.unbounded().end());
+
+    return found;
+}
+
+bool SE2PolygonSpace::collides(const Eigen::MatrixX2d& placed, const Eigen::VectorXd& state, const std::vector<int>& obstacles) const
+{
+    double c = std::cos(state(2)), s = std::sin(state(2));
+
+    for (int i : obstacles) {
+        const Polygon& obstacle = _obstacles[i];
+
+        // Also catches a footprint wholly inside an obstacle, whose facets all lie inside it
+        for (int k = 0; k < placed.rows(); k++) {
+            int next = k + 1 < placed.rows() ? k + 1 : 0;
+            if (segment_intersects_polygon({placed.row(k), placed.row(next)}, obstacle) > 0)
+                return true;
+        }
+
+        // That leaves an obstacle wholly inside the footprint, which only a solid one can be
+        if (obstacle.is_solid()) {
+            Eigen::Vector2d offset = obstacle[0] - state.head<2>();
+            Eigen::Vector2d local{c * offset.x() + s * offset.y(), -s * offset.x() + c * offset.y()};
+
+            if (inside_polygon(local, _footprint))
+                return true;
+        }
+    }
+
+    return false;
+}
+
+Eigen::Vector3d SE2PolygonSpace::lower() const
+{
+    return {_xrange.first, _yrange.first, -M_PI};
+}
+
+Eigen::Vector3d SE2PolygonSpace::upper() const
+{
+    return {_xrange.second, _yrange.second, M_PI};
+}
@@ -1,7 +1,12 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <queue>
 #include <unordered_map>
 #include <queue>
 #include "roadmap.hpp"
+#include "search_roadmap.hpp"
+#include "resumable_search.hpp"
 
 
 struct pairCompare {
@@ -43,6 +48,15 @@ Eigen::MatrixXd reconstruct_path(MapVectorXd<Eigen::VectorXd>& back_pointer, con
 
 Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state)
 {
+    SearchStatistics statistics;
+
+    return dijkstra(roadmap, start_state, goal_state, statistics);
+}
+
+Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics)
+{
+    statistics = SearchStatistics{};
+
     MapVectorXd<double> cost_so_far = MAPVECTORXD(double);
 
     Eigen::MatrixXd states = roadmap.get_states();
@@ -65,6 +79,12 @@ Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_st
         Eigen::VectorXd current_state = current.first;
         double path_cost = current.second;
 
+        // Skip stale entries, left behind when a cheaper path to the node was found, like alt_search does
+        if (path_cost > cost_so_far[current_state])
+            continue;
+
+        statistics.n_expansions++;
+
         if (vector_equality(current_state, goal_state))
             return reconstruct_path(back_pointer, start_state, goal_state);
 
@@ -73,6 +93,10 @@ Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_st
         const Eigen::VectorXd& costs = node.ref_costs();
 
         for (int i=0; i < neighbors.rows(); i++) {
+            // Edges found to be invalid are kept in the roadmap, but never taken
+            if (node._validity[i] == EdgeValidity::invalid)
+                continue;
+
             // Information about the neighbor
             const Eigen::VectorXd& neighbor_state = neighbors.row(i);
             double edge_cost = costs(i);
@@ -93,4 +117,86 @@ Eigen::MatrixXd dijkstra(const Roadmap& roadmap, const Eigen::VectorXd& start_st
     }
 
     return {};
-}
\ No newline at end of file
+}
+
+/* Searches on the indexed graph */
+
+typedef std::pair<double, int> CostIndexPair;
+typedef std::priority_queue<CostIndexPair, std::vector<CostIndexPair>, std::greater<CostIndexPair>> MinCostIndexQueue;
+
+std::vector<double> shortest_path_costs(const RoadmapGraph& graph, int source)
+{
+    const std::vector<int>& offsets = graph.offsets();
+    const std::vector<int>& targets = graph.targets();
+    const std::vector<double>& costs = graph.costs();
+
+    std::vector<double> cost_so_far(graph.n_nodes(), INFINITY);
+    cost_so_far[source] = 0.;
+
+    MinCostIndexQueue queue;
+    queue.push({0., source});
+
+    while (!queue.empty()) {
+        CostIndexPair current = queue.top();
+        queue.pop();
+
+        int u = current.second;
+        if (current.first > cost_so_far[u])
+            continue;   // Stale queue entry
+
+        for (int e = offsets[u]; e < offsets[u + 1]; e++) {
+            double new_cost = current.first + costs[e];
+
+            if (new_cost < cost_so_far[targets[e]]) {
+                cost_so_far[targets[e]] = new_cost;
+                queue.push({new_cost, targets[e]});
+            }
+        }
+    }
+
+    return cost_so_far;
+}
+
+/*  Lower bound on the cost between two nodes from the triangle inequality over the landmarks
+
+    The roadmap is undirected, so d(v, t) >= |d(L, t) - d(L, v)| for every landmark L. A landmark that
+    reaches exactly one of the two nodes proves they are in different components.
+*/
+double landmark_bound(const Eigen::MatrixXd& landmark_distances, int v, int t)
+{
+    double bound = 0.;
+
+    for (int l = 0; l < landmark_distances.rows(); l++) {
+        double dv = landmark_distances(l, v);
+        double dt = landmark_distances(l, t);
+
+        if (std::isinf(dv) || std::isinf(dt)) {
+            if (std::isinf(dv) != std::isinf(dt))
+                return INFINITY;
+            continue;
+        }
+
+        bound = std::max(bound, std::abs(dt - dv));
+    }
+
+    return bound;
+}
+
+Eigen::MatrixXd alt_search(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state)
+{
+    SearchStatistics statistics;
+
+    return alt_search(roadmap, start_state, goal_state, statistics);
+}
+
+Eigen::MatrixXd alt_search(const Roadmap& roadmap, const Eigen::VectorXd& start_state, const Eigen::VectorXd& goal_state, SearchStatistics& statistics)
+{
+    statistics = SearchStatistics{};
+
+    ResumableSearch search{roadmap, start_state, goal_state};
+    search.step(std::numeric_limits<int>::max());
+
+    statistics.n_expansions = search.get_n_expansions();
+
+    return search.path();
+}
@@ -1,35 +1,98 @@
-#include <random>
 #include "search_space.hpp"
 
 
 Eigen::MatrixXd PolygonSpace::sample_free_space(int n) const
 {
-    Eigen::MatrixXd samples(n, 2);
+    RandomStream stream = next_stream();
+    return sample_free_space(n, stream);
+}
+
+Eigen::MatrixXd PolygonSpace::sample_free_space(int n, RandomStream& stream) const
+{
+    if (!_raster.empty()) {
+        Eigen::MatrixXd samples(n, 2);
 
-    for (int i=0; i<n; i++) {
-        Eigen::Vector2d sample;
-        int count = 0;
-        do {
-            sample = {_sample_x(), _sample_y()};
-            count++;
-        } while(inside_any_polygon(sample, _polygons) && count < 1000000);
+        // Only samples from cells that an obstacle crosses can be in collision
+        for (int i = 0; i < n; i++) {
+            bool found = false;
+            for (int draw = 0; draw < MAX_FREE_SPACE_DRAWS && !found; draw++) {
+                bool mixed;
+                samples.row(i) = _raster.draw(stream, mixed);
+                found = !mixed || !inside_obstacle(samples.row(i));
+            }
 
-        samples.row(i) = sample;
+            if (!found)
+                throw NoFreeSpaceException{};
+        }
+
+        return samples;
     }
 
+    Eigen::Vector2d lower{_xrange.first, _yrange.first};
+    Eigen::Vector2d upper{_xrange.second, _yrange.second};
+
+    return sample_rejecting(n, lower, upper, stream, [this](const Eigen::Vector2d& sample) {
+        return inside_obstacle(sample);
+    });
+}
+
+Eigen::MatrixXd PolygonSpace::sample_space(int n, RandomStream& stream) const
+{
+    Eigen::MatrixXd samples(n, 2);
+    draw_candidates(samples, Eigen::Vector2d{_xrange.first, _yrange.first}, Eigen::Vector2d{_xrange.second, _yrange.second}, stream);
+
     return samples;
 }
 
+bool PolygonSpace::valid_state(const Eigen::VectorXd& state) const
+{
+    if (state(0) < _xrange.first || state(0) > _xrange.second || state(1) < _yrange.first || state(1) > _yrange.second)
+        return false;
+
+    return !inside_obstacle(state);
+}
+
 bool PolygonSpace::valid_transition(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
 {
-    std::pair<Eigen::VectorXd, Eigen::VectorXd> segment = {a, b};
-    for (auto polygon : _polygons) {
-        if (segment_intersects_polygon(segment, polygon) > 0)
+    std::pair<Eigen::Vector2d, Eigen::Vector2d> segment = {a, b};
+
+    for (int i : _index.along(segment.first, segment.second)) {
+        if (segment_intersects_polygon(segment, _polygons[i]) > 0)
+            return false;
+    }
+    for (int i : _index.unbounded()) {
+        if (segment_intersects_polygon(segment, _polygons[i]) > 0)
             return false;
     }
     return true;
 }
 
+void PolygonSpace::set_free_space_raster(int resolution)
+{
+    if (resolution < 1) {
+        _raster = FreeSpaceRaster{};
+        return;
+    }
+
+    _raster = FreeSpaceRaster{_polygons, _index, _xrange, _yrange, resolution};
+
+    if (_raster.empty())
+        throw NoFreeSpaceException{};
+}
+
+bool PolygonSpace::inside_obstacle(const Eigen::Vector2d& point) const
+{
+    for (int i : _index.at(point)) {
+        if (inside_polygon(point, _polygons[i]))
+            return true;
+    }
+    for (int i : _index.unbounded()) {
+        if (inside_polygon(point, _polygons[i]))
+            return true;
+    }
+    return false;
+}
+
 double PolygonSpace::transition_cost(const Eigen::VectorXd& a, const Eigen::VectorXd& b) const
 {
     Eigen::VectorXd ab = b - a;
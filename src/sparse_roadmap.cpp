@@ -0,0 +1,239 @@
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include "kd_tree.hpp"
+#include "probabilistic_roadmap.hpp"
+#include "random_stream.hpp"
+
+
+// Samples are drawn from the search space in blocks, so a Python search space is called once per block
+const int SPARSE_SAMPLE_BLOCK_SIZE = 64;
+
+struct SparseEdge {
+    int neighbor;
+    double cost;
+    double length;  // Distance between the states, which the stretch is measured in
+};
+
+class SparseRoadmap {
+    kdTree _tree;
+    std::vector<Eigen::VectorXd> _states;
+    std::vector<std::vector<SparseEdge>> _adjacency;
+
+    // Disjoint sets of the guards, for the connected components
+    std::vector<int> _component_parent;
+
+public:
+    int size() const {return _states.size();}
+    const Eigen::VectorXd& state(int v) const {return _states[v];}
+
+    int add_guard(const Eigen::VectorXd& state) {
+        _tree.append_state(state);
+        _states.push_back(state);
+        _adjacency.emplace_back();
+        _component_parent.push_back(size() - 1);
+
+        return size() - 1;
+    }
+
+    void add_edge(int v, int u, double cost) {
+        double length = (_states[v] - _states[u]).norm();
+
+        _adjacency[v].push_back({u, cost, length});
+        _adjacency[u].push_back({v, cost, length});
+        _component_parent[component(v)] = component(u);
+    }
+
+    int component(int v) {
+        while (_component_parent[v] != v) {
+            _component_parent[v] = _component_parent[_component_parent[v]];
+            v = _component_parent[v];
+        }
+
+        return v;
+    }
+
+    // Guards within the radius of the state, nearest first
+    std::vector<int> guards_within(const Eigen::VectorXd& state, double radius) const {
+        if (_states.empty())
+            return {};
+
+        Eigen::VectorXi ids = _tree.radius_search(state, radius).first;
+
+        return {ids.data(), ids.data() + ids.size()};
+    }
+
+    // Whether some path from the source to the target is no longer than the bound
+    bool path_within(int source, int target, double bound) const {
+        std::unordered_map<int, double> length_so_far{{source, 0.}};
+
+        typedef std::pair<double, int> LengthIndexPair;
+        std::priority_queue<LengthIndexPair, std::vector<LengthIndexPair>, std::greater<LengthIndexPair>> open;
+        open.push({0., source});
+
+        while (!open.empty()) {
+            auto [length, v] = open.top();
+            open.pop();
+
+            if (v == target)
+                return true;
+            if (length > length_so_far[v])
+                continue;
+
+            for (const SparseEdge& edge : _adjacency[v]) {
+                double new_length = length + edge.length;
+                if (new_length > bound)
+                    continue;
+
+                auto it = length_so_far.find(edge.neighbor);
+                if (it == length_so_far.end() || new_length < it->second) {
+                    length_so_far[edge.neighbor] = new_length;
+                    open.push({new_length, edge.neighbor});
+                }
+            }
+        }
+
+        return false;
+    }
+
+    Roadmap to_roadmap(int state_size) const {
+        Roadmap roadmap{state_size};
+
+        // Each edge is added with whichever of its guards comes second
+        for (int v = 0; v < size(); v++) {
+            std::vector<SparseEdge> earlier;
+            for (const SparseEdge& edge : _adjacency[v]) {
+                if (edge.neighbor < v)
+                    earlier.push_back(edge);
+            }
+
+            Eigen::MatrixXd neighbors(earlier.size(), state_size);
+            Eigen::VectorXd costs(earlier.size());
+            for (int i = 0; i < (int)earlier.size(); i++) {
+                neighbors.row(i) = _states[earlier[i].neighbor];
+                costs(i) = earlier[i].cost;
+            }
+
+            roadmap.add_node(_states[v], neighbors, costs);
+        }
+
+        return roadmap;
+    }
+};
+
+Roadmap build_sparse_roadmap(const SearchSpace& search_space, double visibility_radius, double stretch, int max_failures, int max_samples, long seed)
+{
+    // Written so that a NaN stretch is rejected too
+    if (!(stretch >= 1.))
+        throw BadParameterException{"The stretch of a sparse roadmap has to be at least 1"};
+
+    RandomStream stream{seed < 0 ? entropy_seed() : (uint64_t)seed};
+
+    SparseRoadmap sparse;
+
+    Eigen::MatrixXd samples;
+    int next_sample = SPARSE_SAMPLE_BLOCK_SIZE;
+
+    int n_failures = 0;
+    for (int i = 0; i < max_samples && n_failures < max_failures; i++) {
+        if (next_sample == SPARSE_SAMPLE_BLOCK_SIZE) {
+            samples = search_space.sample_free_space(SPARSE_SAMPLE_BLOCK_SIZE, stream);
+            next_sample = 0;
+        }
+        Eigen::VectorXd sample = samples.row(next_sample++);
+
+        std::vector<int> nearby = sparse.guards_within(sample, visibility_radius);
+
+        // Check the transitions to every nearby guard in one batch
+        Eigen::MatrixXd from = sample.transpose().replicate(nearby.size(), 1);
+        Eigen::MatrixXd to(nearby.size(), sample.size());
+        for (int j = 0; j < (int)nearby.size(); j++)
+            to.row(j) = sparse.state(nearby[j]);
+
+        VectorXb visible = search_space.valid_transitions(from, to);
+
+        std::vector<int> guards;
+        for (int j = 0; j < (int)nearby.size(); j++) {
+            if (visible(j))
+                guards.push_back(nearby[j]);
+        }
+
+        // Coverage
+        if (guards.empty()) {
+            sparse.add_guard(sample);
+            n_failures = 0;
+            continue;
+        }
+
+        Eigen::MatrixXd guard_states(guards.size(), sample.size());
+        for (int j = 0; j < (int)guards.size(); j++)
+            guard_states.row(j) = sparse.state(guards[j]);
+
+        Eigen::VectorXd costs = search_space.transition_costs(from.topRows(guards.size()), guard_states);
+
+        // Connectivity, joining each component to the nearest of its guards that the sample sees
+        std::vector<int> bridged;
+        std::vector<int> components;
+        for (int j = 0; j < (int)guards.size(); j++) {
+            int component = sparse.component(guards[j]);
+            if (std::find(components.begin(), components.end(), component) == components.end()) {
+                components.push_back(component);
+                bridged.push_back(j);
+            }
+        }
+
+        if (components.size() > 1) {
+            int v = sparse.add_guard(sample);
+            for (int j : bridged)
+                sparse.add_edge(v, guards[j], costs(j));
+
+            n_failures = 0;
+            continue;
+        }
+
+        // Quality, against the nearest guard
+        std::vector<int> shortcuts;
+        for (int j = 1; j < (int)guards.size(); j++) {
+            double length_through_sample = (guard_states.row(0) - sample.transpose()).norm() + (guard_states.row(j) - sample.transpose()).norm();
+
+            if (!sparse.path_within(guards[0], guards[j], stretch * length_through_sample))
+                shortcuts.push_back(j);
+        }
+
+        if (!shortcuts.empty()) {
+            // A direct edge between the guards is the shortest path there is, and costs no node
+            Eigen::MatrixXd nearest_states = guard_states.row(0).replicate(shortcuts.size(), 1);
+            Eigen::MatrixXd other_states(shortcuts.size(), sample.size());
+            for (int k = 0; k < (int)shortcuts.size(); k++)
+                other_states.row(k) = guard_states.row(shortcuts[k]);
+
+            VectorXb direct = search_space.valid_transitions(nearest_states, other_states);
+            Eigen::VectorXd direct_costs = search_space.transition_costs(nearest_states, other_states);
+
+            std::vector<int> through_sample;
+            for (int k = 0; k < (int)shortcuts.size(); k++) {
+                if (direct(k))
+                    sparse.add_edge(guards[0], guards[shortcuts[k]], direct_costs(k));
+                else
+                    through_sample.push_back(shortcuts[k]);
+            }
+
+            if (!through_sample.empty()) {
+                int v = sparse.add_guard(sample);
+                sparse.add_edge(v, guards[0], costs(0));
+                for (int j : through_sample)
+                    sparse.add_edge(v, guards[j], costs(j));
+            }
+
+            n_failures = 0;
+            continue;
+        }
+
+        n_failures++;
+    }
+
+    return sparse.to_roadmap(search_space.state_size());
+}
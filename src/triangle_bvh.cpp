@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include "triangle_bvh.hpp"
+
+
+// Number of bins the centroids are sorted into along each axis when looking for a split
+const int SAH_BINS = 16;
+
+// Cost of visiting an inner node relative to testing one triangle
+const double TRAVERSAL_COST = 1.;
+
+// Leaves are always split above this many triangles, as long as their centroids can be told apart
+const int MAX_LEAF_SIZE = 8;
+
+double surface_area(const Eigen::Vector3d& lower, const Eigen::Vector3d& upper)
+{
+    Eigen::Vector3d extent = (upper - lower).cwiseMax(0.);
+    return 2. * (extent.x() * extent.y() + extent.y() * extent.z() + extent.z() * extent.x());
+}
+
+TriangleBVH::TriangleBVH(const std::vector<Triangle>& triangles)
+{
+    int n = triangles.size();
+    if (n == 0)
+        return;
+
+    std::vector<Eigen::Vector3d> lower(n), upper(n), centroids(n);
+    for (int i = 0; i < n; i++) {
+        lower[i] = triangles[i].a.cwiseMin(triangles[i].b).cwiseMin(triangles[i].c);
+        upper[i] = triangles[i].a.cwiseMax(triangles[i].b).cwiseMax(triangles[i].c);
+        centroids[i] = (triangles[i].a + triangles[i].b + triangles[i].c) / 3.;
+    }
+
+    _order.resize(n);
+    std::iota(_order.begin(), _order.end(), 0);
+
+    _nodes.reserve(2 * n);
+    build(lower, upper, centroids, 0, n, 0);
+}
+
+int TriangleBVH::build(const std::vector<Eigen::Vector3d>& lower, const std::vector<Eigen::Vector3d>& upper,
+    const std::vector<Eigen::Vector3d>& centroids, int begin, int end, int depth)
+{
+    int index = _nodes.size();
+    _nodes.emplace_back();
+    _depth = std::max(_depth, depth);
+
+    Eigen::Vector3d node_lower = lower[_order[begin]], node_upper = upper[_order[begin]];
+    Eigen::Vector3d centroid_lower = centroids[_order[begin]], centroid_upper = centroids[_order[begin]];
+    for (int k = begin; k < end; k++) {
+        node_lower = node_lower.cwiseMin(lower[_order[k]]);
+        node_upper = node_upper.cwiseMax(upper[_order[k]]);
+        centroid_lower = centroid_lower.cwiseMin(centroids[_order[k]]);
+        centroid_upper = centroid_upper.cwiseMax(centroids[_order[k]]);
+    }
+
+    _nodes[index].lower = node_lower;
+    _nodes[index].upper = node_upper;
+
+    auto make_leaf = [&]() {
+        _nodes[index].first = begin;
+        _nodes[index].count = end - begin;
+        return index;
+    };
+
+    int count = end - begin;
+    if (count <= 2 || depth >= MAX_DEPTH)
+        return make_leaf();
+
+    // Best split over the bins of every axis, with the cost of each side relative to the node's area
+    double node_area = surface_area(node_lower, node_upper);
+    double best_cost = INFINITY;
+    int best_axis = -1, best_bin = 0;
+
+    Eigen::Vector3d extent = centroid_upper - centroid_lower;
+
+    for (int axis = 0; axis < 3; axis++) {
+        if (extent(axis) <= 0.)
+            continue;
+
+        std::array<int, SAH_BINS> bin_counts{};
+        std::array<Eigen::Vector3d, SAH_BINS> bin_lower, bin_upper;
+        bin_lower.fill(Eigen::Vector3d::Constant(INFINITY));
+        bin_upper.fill(Eigen::Vector3d::Constant(-INFINITY));
+
+        for (int k = begin; k < end; k++) {
+            int i = _order[k];
+            int bin = std::min((int)(SAH_BINS * (centroids[i](axis) - centroid_lower(axis)) / extent(axis)), SAH_BINS - 1);
+            bin_counts[bin]++;
+            bin_lower[bin] = bin_lower[bin].cwiseMin(lower[i]);
+            bin_upper[bin] = bin_upper[bin].cwiseMax(upper[i]);
+        }
+
+        // Areas and counts of everything right of each boundary, swept from the right
+        std::array<double, SAH_BINS> right_area;
+        std::array<int, SAH_BINS> right_count;
+        Eigen::Vector3d sweep_lower = Eigen::Vector3d::Constant(INFINITY), sweep_upper = Eigen::Vector3d::Constant(-INFINITY);
+        int sweep_count = 0;
+        for (int bin = SAH_BINS - 1; bin > 0; bin--) {
+            sweep_lower = sweep_lower.cwiseMin(bin_lower[bin]);
+            sweep_upper = sweep_upper.cwiseMax(bin_upper[bin]);
+            sweep_count += bin_counts[bin];
+            right_area[bin] = surface_area(sweep_lower, sweep_upper);
+            right_count[bin] = sweep_count;
+        }
+
+        sweep_lower = Eigen::Vector3d::Constant(INFINITY);
+        sweep_upper = Eigen::Vector3d::Constant(-INFINITY);
+        sweep_count = 0;
+        for (int bin = 1; bin < SAH_BINS; bin++) {
+            sweep_lower = sweep_lower.cwiseMin(bin_lower[bin - 1]);
+            sweep_upper = sweep_upper.cwiseMax(bin_upper[bin - 1]);
+            sweep_count += bin_counts[bin - 1];
+
+            if (sweep_count == 0 || right_count[bin] == 0)
+                continue;
+
+            double cost = TRAVERSAL_COST + (surface_area(sweep_lower, sweep_upper) * sweep_count + right_area[bin] * right_count[bin]) / node_area;
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_axis = axis;
+                best_bin = bin;
+            }
+        }
+    }
+
+    // Triangles with the same centroid cannot be split, and small leaves are kept if they are cheaper
+    if (best_axis < 0 || (best_cost >= count && count <= MAX_LEAF_SIZE))
+        return make_leaf();
+
+    auto middle = std::partition(_order.begin() + begin, _order.begin() + end, [&](int i) {
+        int bin = std::min((int)(SAH_BINS * (centroids[i](best_axis) - centroid_lower(best_axis)) / extent(best_axis)), SAH_BINS - 1);
+        return bin < best_bin;
+    });
+    int mid = middle - _order.begin();
+
+    build(lower, upper, centroids, begin, mid, depth + 1);
+    _nodes[index].first = build(lower, upper, centroids, mid, end, depth + 1);
+
+    return index;
+}
@@ -0,0 +1,32 @@
+from random import choices
+from typing import Tuple
+
+import numpy as np
+from navitools import ContractionHierarchy, PolygonSpace, SearchStatistics, build_prm, dijkstra
+from navitools.testing import make_random_triangles, path_cost
+
+
+def test_contraction_hierarchy_query(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace(make_random_triangles(20, xrange, yrange), xrange, yrange)
+
+    roadmap = build_prm(1000, 10, 10, search_space)
+    hierarchy = ContractionHierarchy(roadmap)
+
+    assert hierarchy.n_states == roadmap.n_states
+
+    for _ in range(50):
+        start, goal = choices(roadmap.states, k=2)
+
+        statistics = SearchStatistics()
+        path = hierarchy.query(start, goal, statistics)
+        dijkstra_path = dijkstra(roadmap, start, goal)
+
+        if not dijkstra_path.size:
+            assert not path.size
+            continue
+
+        # Shortcuts are unpacked, so every step of the path is an edge of the roadmap
+        assert np.all(path[0] == start)
+        assert np.all(path[-1] == goal)
+        assert np.isclose(path_cost(roadmap, path), path_cost(roadmap, dijkstra_path))
+        assert statistics.n_expansions > 0
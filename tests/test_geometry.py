@@ -1,5 +1,9 @@
+from fractions import Fraction
+
 import numpy as np
-from navitools import Polygon, inside_polygon, segments_intersect
+from navitools import Polygon, RandomStream, distance_to_boundary, inside_polygon, inside_polygons, segment_intersects_polygon, \
+    segments_intersect, segments_intersect_polygons
+from navitools.testing import make_random_triangles
 
 
 def test_polygon_instantiation():
@@ -62,3 +66,150 @@ def test_segments_intersect():
     ab = (np.array([0., 1.]), np.array([.4, 1.]))
     cd = (np.array([.5, 1.]), np.array([1., 1.]))
     assert segments_intersect(ab, cd) == 0
+
+
+def test_near_degenerate_predicates():
+    # A clockwise triangle far smaller than the old epsilon threshold
+    assert Polygon(1e-9 * np.array([[1., 0.], [0., 0.], [0., 1.]])).is_hollow
+    assert Polygon(1e-9 * np.array([[0., 0.], [1., 0.], [0., 1.]])).is_solid
+
+    # Crossing segments at any scale
+    for scale in (1e-8, 1., 1e8):
+        ab = (np.array([0., 0.]), np.array([scale, scale]))
+        cd = (np.array([0., scale]), np.array([scale, 0.]))
+        assert segments_intersect(ab, cd) == 1
+
+    # A segment wholly inside a colinear segment overlaps it
+    ab = (np.array([0., 0.]), np.array([4., 0.]))
+    cd = (np.array([1., 0.]), np.array([2., 0.]))
+    assert segments_intersect(ab, cd) == 2
+
+    # Points a few ulps either side of the line y = x, where rounding the determinant gets the sign wrong
+    ab = (np.array([-12., -12.]), np.array([24., 24.]))
+    ulp = 2. ** -53
+    for i in range(16):
+        for j in range(16):
+            point = np.array([.5 + i * ulp, .5 + j * ulp])
+            assert segments_intersect(ab, (point, point)) == (i == j)
+
+
+def reference_inside_polygon(point, polygon: Polygon) -> bool:
+    # Winding number with exact orientations, as inside_polygon is defined
+    def is_left(p0, p1, p2) -> Fraction:
+        (x0, y0), (x1, y1), (x2, y2) = [(Fraction(p[0]), Fraction(p[1])) for p in (p0, p1, p2)]
+        return (x1 - x0) * (y2 - y0) - (x2 - x0) * (y1 - y0)
+
+    wn = 0
+    for i in range(polygon.n_points):
+        a, b = polygon[i], polygon[i + 1]
+        if a[1] <= point[1] < b[1] and is_left(a, b, point) > 0:
+            wn += 1
+        elif b[1] <= point[1] < a[1] and is_left(a, b, point) <= 0:
+            wn -= 1
+
+    return wn != 0 if polygon.is_solid else wn == 0
+
+
+def test_convex_polygon(n_points: int = 16, n_queries: int = 500):
+    angles = np.linspace(0, 2 * np.pi, n_points, endpoint=False) + 0.1
+    points = np.column_stack([np.cos(angles), np.sin(angles)])
+
+    assert Polygon(points).is_convex
+    assert Polygon(points[::-1].copy()).is_convex
+    assert not Polygon(np.array([[0., 0.], [2., 0.], [2., 1.], [1., 1.], [1., 2.], [0., 2.]])).is_convex
+
+    # Turns the same way at every vertex, but winds around twice
+    star = np.array([[np.cos(a), np.sin(a)] for a in 0.1 + 4 * np.pi * np.arange(5) / 5])
+    assert not Polygon(star).is_convex
+
+    stream = RandomStream(0)
+
+    for polygon in (Polygon(points), Polygon(points[::-1].copy())):
+        # Random points, and points on the vertices, on the facets and on the diagonals from vertex 0
+        queries = list(3 * stream.uniform_block(n_queries, 2) - 1.5)
+        for k in range(n_queries):
+            t = stream.uniform(0, 1)
+            queries += [polygon[k], polygon[k] + t * (polygon[k + 1] - polygon[k]), t * polygon[k] + (1 - t) * polygon[0]]
+
+        for point in queries:
+            assert inside_polygon(point, polygon) == reference_inside_polygon(point, polygon)
+
+
+def reference_segment_intersects_polygon(segment, polygon: Polygon) -> int:
+    # Facet by facet, as segment_intersects_polygon is defined
+    for i in range(polygon.n_points):
+        code = segments_intersect(segment, (polygon[i], polygon[i + 1]))
+        if code > 0:
+            return code
+
+    if inside_polygon(segment[0], polygon) and inside_polygon(segment[1], polygon):
+        return 3
+
+    return 0
+
+
+def test_segment_intersects_polygon(n_points: int = 12, n_segments: int = 2_000):
+    # More facets than fit in one block of the vectorized test
+    angles = np.linspace(0, 2 * np.pi, n_points, endpoint=False)
+    radii = np.where(np.arange(n_points) % 2, 1., 2.)
+    points = np.column_stack([radii * np.cos(angles), radii * np.sin(angles)])
+
+    stream = RandomStream(0)
+
+    for polygon in (Polygon(points), Polygon(points[::-1].copy())):
+        for k in range(n_segments):
+            a, b = 6 * stream.uniform_block(2, 2) - 3
+
+            # Segments through vertices and along facets
+            if k % 4 == 1:
+                a = polygon[k]
+            elif k % 4 == 2:
+                t, s = 3 * stream.uniform_block(1, 2)[0] - 1
+                a = polygon[k] + t * (polygon[k + 1] - polygon[k])
+                b = polygon[k] + s * (polygon[k + 1] - polygon[k])
+
+            segment = (a, b)
+            assert segment_intersects_polygon(segment, polygon) == reference_segment_intersects_polygon(segment, polygon)
+
+
+def test_batch_polygon_queries(n: int = 2_000):
+    # A clockwise polygon is hollow and contains everything outside it
+    boundary = Polygon(np.array([[-9., 9.], [9., 9.], [9., -9.], [-9., -9.]]))
+    polygons = make_random_triangles(100, (-10, 10), (-10, 10)) + [boundary]
+
+    stream = RandomStream(0)
+    points = 20 * stream.uniform_block(n, 2) - 10
+    segments = np.hstack([points, points + 4 * (stream.uniform_block(n, 2) - 0.5)])
+
+    def first(hits) -> int:
+        return next((i for i, hit in enumerate(hits) if hit), -1)
+
+    for n_threads in (1, 0):
+        inside = inside_polygons(points, polygons, n_threads=n_threads)
+        intersected = segments_intersect_polygons(segments, polygons, n_threads=n_threads)
+
+        for point, i in zip(points, inside):
+            assert i == first(inside_polygon(point, polygon) for polygon in polygons)
+
+        for segment, i in zip(segments, intersected):
+            assert i == first(segment_intersects_polygon((segment[:2], segment[2:]), polygon) for polygon in polygons)
+
+    assert len(inside_polygons(np.empty((0, 2)), polygons)) == 0
+    assert np.all(inside_polygons(points, []) == -1)
+
+
+def test_distance_to_boundary(n_points: int = 12, n: int = 500):
+    # More facets than fit in one block, and a repeated vertex that makes a facet of no length
+    angles = np.linspace(0, 2 * np.pi, n_points, endpoint=False)
+    radii = np.where(np.arange(n_points) % 2, 1., 2.)
+    points = np.column_stack([radii * np.cos(angles), radii * np.sin(angles)])
+    polygon = Polygon(np.vstack([points[:3], points[2:]]))
+
+    def reference(point: np.ndarray) -> float:
+        starts, ends = points, np.roll(points, -1, axis=0)
+        ts = np.clip(np.einsum('ij,ij->i', point - starts, ends - starts) / np.sum((ends - starts) ** 2, axis=1), 0, 1)
+        return np.min(np.linalg.norm(point - starts - ts[:, None] * (ends - starts), axis=1))
+
+    for point in 6 * RandomStream(0).uniform_block(n, 2) - 3:
+        assert np.isclose(distance_to_boundary(point, polygon), reference(point))
+    assert distance_to_boundary(points[5], polygon) == 0.
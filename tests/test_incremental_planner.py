@@ -0,0 +1,45 @@
+from random import choices, randrange
+from typing import Tuple
+
+import numpy as np
+from navitools import IncrementalPlanner, PolygonSpace, SearchStatistics, build_prm
+from navitools.testing import make_random_triangles
+
+
+def test_incremental_planner_blocked_edges(xrange: Tuple[float, float] = (-10, 10),
+                                           yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace(make_random_triangles(20, xrange, yrange), xrange, yrange)
+
+    roadmap = build_prm(1000, 10, 10, search_space)
+    start, goal = choices(roadmap.states, k=2)
+
+    planner = IncrementalPlanner(roadmap, start, goal)
+    path = planner.plan()
+
+    blocked = []
+    for _ in range(5):
+        if len(path) < 2:
+            break
+
+        # Block an edge of the current path and repair the search
+        i = randrange(len(path) - 1)
+        blocked.append((path[i], path[i + 1]))
+        planner.set_edge_cost(path[i], path[i + 1], np.inf)
+        assert planner.edge_cost(path[i], path[i + 1]) == np.inf
+
+        repaired_statistics = SearchStatistics()
+        path = planner.plan(repaired_statistics)
+
+        # A planner that starts from scratch with the same blocked edges must agree
+        fresh = IncrementalPlanner(roadmap, start, goal)
+        for a, b in blocked:
+            fresh.set_edge_cost(a, b, np.inf)
+
+        fresh_statistics = SearchStatistics()
+        fresh_path = fresh.plan(fresh_statistics)
+
+        assert planner.path_cost == fresh.path_cost or np.isclose(planner.path_cost, fresh.path_cost)
+        assert len(path) == 0 and len(fresh_path) == 0 or np.all(path[0] == start) and np.all(path[-1] == goal)
+
+        for a, b in zip(path[:-1], path[1:]):
+            assert np.isfinite(planner.edge_cost(a, b))
@@ -135,6 +135,34 @@ def test_tree_k_nearest_neighbors(k: int = 10):
         assert np.all(tree_k_nearest == k_nearest)
 
 
+def test_tree_radius_search(radius: float = 30.):
+    for _ in range(100):
+        points = generate_test_points(n=100)
+
+        test_point = np.array([0., 0.])
+
+        distances = np.linalg.norm(points - test_point, axis=1)
+        within = np.flatnonzero(distances <= radius)
+
+        # With the constructor
+        tree = KD_Tree(points)
+
+        ids, tree_distances = tree.radius_search(test_point, radius)
+        assert set(ids) == set(within)
+        assert np.allclose(tree_distances, distances[ids])
+        assert np.all(np.diff(tree_distances) >= 0)
+
+        # Building iteratively, where the ids are the order the points were appended in
+        tree = KD_Tree(np.array([]))
+
+        for point in points:
+            tree.append_state(point)
+
+        ids, _ = tree.radius_search(test_point, radius)
+        assert set(ids) == set(within)
+        assert np.all(tree.states_within(test_point, radius) == points[ids])
+
+
 def test_tree_exceptions():
     points = generate_test_points(n=10)
     tree = KD_Tree(points)
@@ -1,19 +1,24 @@
 from math import ceil
 from typing import Tuple
 
-from navitools import PolygonSpace, build_prm, inside_polygon, segments_intersect
-from navitools.testing import make_random_triangles
+import numpy as np
+import pytest
+from navitools import BadParameterException, ConnectionStrategy, NoStateCheckException, PolygonSpace, RandomStream, SamplingMix, SearchSpace, \
+    build_prm, build_sparse_roadmap, extend_prm, inside_polygon, prm_star_gamma, sample_bridge, sample_gaussian, segments_intersect
+from navitools.testing import make_random_triangles, make_wall_with_gap
 
 
 def test_build_prm(n_samples: int = 100, n_batch: int = 10, k_neighbors: int = 10, min_n_vertices: int = 100,
-                   xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+                   xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10),
+                   n_threads: int = 1, strategy: ConnectionStrategy = ConnectionStrategy.k_nearest,
+                   gamma: float = 1.):
 
     n_triangles = ceil(min_n_vertices / 3)
     triangles = make_random_triangles(n_triangles, xrange, yrange)
 
     search_space = PolygonSpace(triangles, xrange, yrange)
 
-    roadmap = build_prm(n_samples, n_batch, k_neighbors, search_space)
+    roadmap = build_prm(n_samples, n_batch, k_neighbors, search_space, n_threads, strategy, gamma)
 
     for node in roadmap.nodes:
         for triangle in triangles:
@@ -27,3 +32,135 @@ def test_build_prm(n_samples: int = 100, n_batch: int = 10, k_neighbors: int = 1
                 for neighbor_state in node.neighbors:
                     # Assert no transition between states collides with a polygon
                     assert not segments_intersect((node.state, neighbor_state), (a, b))
+
+
+def test_build_prm_parallel():
+    test_build_prm(n_samples=500, n_batch=50, n_threads=4)
+
+
+def test_build_prm_star():
+    test_build_prm(n_samples=500, n_batch=50, strategy=ConnectionStrategy.k_nearest_star)
+    test_build_prm(n_samples=500, n_batch=50, strategy=ConnectionStrategy.radius_star, gamma=prm_star_gamma(400., 2))
+
+
+def test_build_prm_star_default_gamma(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace(make_random_triangles(20, xrange, yrange), xrange, yrange)
+    assert search_space.sampling_volume() == 400.
+
+    # The default gamma is the PRM* bound for the sampling volume
+    default = build_prm(300, 30, 10, search_space, strategy=ConnectionStrategy.radius_star, seed=3)
+    explicit = build_prm(300, 30, 10, search_space, strategy=ConnectionStrategy.radius_star, gamma=prm_star_gamma(400., 2), seed=3)
+    assert np.array_equal(default.states, explicit.states)
+
+    class UnboundedSpace(SearchSpace):
+
+        def __init__(self):
+            super().__init__(2)
+
+        def sample_free_space(self, n: int):
+            return np.random.uniform(0, 1, (n, 2))
+
+    with pytest.raises(BadParameterException):
+        build_prm(100, 10, 10, UnboundedSpace(), strategy=ConnectionStrategy.radius_star)
+
+
+def test_extend_prm(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    triangles = make_random_triangles(20, xrange, yrange)
+    search_space = PolygonSpace(triangles, xrange, yrange)
+
+    roadmap = build_prm(500, 10, 10, search_space)
+    states = roadmap.states
+
+    extend_prm(roadmap, 100, 10, 10, search_space)
+    assert roadmap.n_states == len(states) + 100
+
+    # New nodes in the region, picked from candidates far from the roadmap
+    region_min, region_max = np.array([0., 0.]), np.array([5., 5.])
+    before = {tuple(state) for state in roadmap.states}
+
+    extend_prm(roadmap, 50, 10, 10, search_space, region_min=region_min, region_max=region_max, oversampling=4)
+    assert roadmap.n_states == len(before) + 50
+
+    for node in roadmap.nodes:
+        if tuple(node.state) not in before:
+            assert np.all(node.state >= region_min) and np.all(node.state <= region_max)
+
+        for triangle in triangles:
+            assert not inside_polygon(node.state, triangle)
+
+            for i in range(3):
+                for neighbor_state in node.neighbors:
+                    assert not segments_intersect((node.state, neighbor_state), (triangle[i], triangle[i + 1]))
+
+
+def test_narrow_passage_samplers(n: int = 200):
+    search_space = make_wall_with_gap(0.3)
+
+    for samples in (sample_gaussian(search_space, n, 0.5, RandomStream(1)), sample_bridge(search_space, n, 0.5, RandomStream(2))):
+        assert samples.shape == (n, 2)
+        assert all(search_space.valid_state(sample) for sample in samples)
+
+    # The gap is a tiny share of the free space, but a good share of the bridge samples land in it (the
+    # rest land along the edges of the map, which count as obstacles)
+    bridges = sample_bridge(search_space, n, 0.5, RandomStream(3))
+    assert np.mean((np.abs(bridges[:, 0]) <= 1) & (np.abs(bridges[:, 1]) < 0.15)) > 0.2
+
+    # A sigma <= 0 would put both states of every pair in the same place
+    for sampler in (sample_gaussian, sample_bridge):
+        for sigma in (0., -1., float('nan')):
+            with pytest.raises(BadParameterException):
+                sampler(search_space, n, sigma, RandomStream(4))
+
+    # Without valid_state, no pair could ever tell free space from obstacles
+    class NoStateCheckSpace(SearchSpace):
+
+        def __init__(self):
+            super().__init__(2)
+
+        def sample_free_space(self, n: int):
+            return np.random.uniform(0, 1, (n, 2))
+
+    for sampler in (sample_gaussian, sample_bridge):
+        with pytest.raises(NoStateCheckException):
+            sampler(NoStateCheckSpace(), n, 0.5, RandomStream(4))
+
+
+def test_build_prm_sampling_mix():
+    search_space = make_wall_with_gap(0.3)
+    mix = SamplingMix(gaussian_ratio=0.1, bridge_ratio=0.2, sigma=0.5)
+
+    roadmap = build_prm(2500, 50, 10, search_space, seed=0, mix=mix)
+
+    # Both sides of the wall end up in the same component
+    labels = roadmap.component_labels
+    states = roadmap.states
+    left = np.bincount(labels[states[:, 0] < -1]).argmax()
+    right = np.bincount(labels[states[:, 0] > 1]).argmax()
+    assert left == right
+
+
+def test_build_sparse_roadmap(visibility_radius: float = 3.):
+    search_space = make_wall_with_gap(2.)
+
+    n_states = []
+    for stretch in (1.5, 3.):
+        roadmap = build_sparse_roadmap(search_space, visibility_radius, stretch, seed=0)
+        n_states.append(roadmap.n_states)
+
+        assert roadmap.count_components() == 1
+
+        # Nearly every free state can reach a node of the roadmap directly
+        states = roadmap.states
+        samples = search_space.sample_free_space(100, RandomStream(1))
+        covered = [
+            any(np.linalg.norm(state - sample) <= visibility_radius and search_space.valid_transition(sample, state)
+                for state in states)
+            for sample in samples
+        ]
+        assert np.mean(covered) > 0.95
+
+    # A looser stretch needs fewer nodes
+    assert n_states[0] >= n_states[1]
+
+    with pytest.raises(BadParameterException):
+        build_sparse_roadmap(search_space, visibility_radius, 0.5, seed=0)
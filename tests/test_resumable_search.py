@@ -0,0 +1,74 @@
+from random import choices
+from typing import Tuple
+
+import numpy as np
+import pytest
+from navitools import PolygonSpace, ResumableSearch, RoadmapChangedException, SearchStatus, build_prm, dijkstra
+from navitools.testing import make_random_triangles
+
+
+def test_resumable_search_steps(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace(make_random_triangles(20, xrange, yrange), xrange, yrange)
+
+    roadmap = build_prm(1000, 10, 10, search_space)
+
+    for use_landmarks in (False, True):
+        if use_landmarks:
+            roadmap.preprocess_landmarks(4)
+
+        start, goal = choices(roadmap.states, k=2)
+        search = ResumableSearch(roadmap, start, goal, use_landmarks)
+
+        # Spread the search over many small steps
+        n_steps = 0
+        while search.step(5) == SearchStatus.in_progress:
+            partial = search.best_partial_path()
+            assert np.all(partial[0] == start)
+
+            assert search.n_expansions == 5 * (n_steps + 1)
+            n_steps += 1
+
+        expected = dijkstra(roadmap, start, goal)
+        if expected.size:
+            assert search.status == SearchStatus.found
+            assert np.all(search.path()[0] == start)
+            assert np.all(search.path()[-1] == goal)
+            assert np.all(search.best_partial_path()[-1] == goal)
+        else:
+            assert search.status == SearchStatus.failed
+            assert not search.path().size
+
+
+def test_resumable_search_step_for(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace([], xrange, yrange)
+
+    roadmap = build_prm(1000, 10, 10, search_space)
+    start, goal = choices(roadmap.states, k=2)
+
+    search = ResumableSearch(roadmap, start, goal)
+    while search.step_for(100.) == SearchStatus.in_progress:
+        pass
+
+    assert search.status == SearchStatus.found
+
+
+def test_resumable_search_roadmap_changed(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace([], xrange, yrange)
+
+    roadmap = build_prm(1000, 10, 10, search_space)
+    start, goal = choices(roadmap.states, k=2)
+
+    search = ResumableSearch(roadmap, start, goal)
+    search.step(5)
+
+    # A node added while the search is suspended rebuilds the graph the search reads
+    roadmap.add_node(np.array([100., 100.]), np.empty((0, 2)), np.empty(0))
+
+    with pytest.raises(RoadmapChangedException):
+        search.step(5)
+    with pytest.raises(RoadmapChangedException):
+        search.best_partial_path()
+
+    # A new search sees the new node
+    search = ResumableSearch(roadmap, start, np.array([100., 100.]))
+    assert search.step(roadmap.n_states) == SearchStatus.failed
@@ -1,5 +1,7 @@
+import pickle
+
 import numpy as np
-from navitools import Roadmap
+from navitools import EdgeValidity, MissingEdgeRoadmapException, Roadmap, alt_search, dijkstra
 from navitools.testing import generate_test_points
 
 
@@ -93,3 +95,67 @@ def test_add_nodes_with_discovered_neighbors(k: int = 5):
     all_costs_inds = all_costs.argsort()
     all_costs_ascnd = all_costs[all_costs_inds]
     assert np.all(costs == all_costs_ascnd[:k])
+
+
+def test_pickle_roadmap_with_landmarks():
+    points = generate_test_points(n=5)
+
+    roadmap = Roadmap(2)
+    roadmap.add_node(points[0], np.array([]), np.array([]))
+    roadmap.add_node(points[1], np.array([points[0]]), np.array([1.]))
+    roadmap.add_node(points[2], np.array([points[0], points[1]]), np.array([2., 3.]))
+    roadmap.add_node(points[3], np.array([points[2]]), np.array([4.]))
+    roadmap.add_node(points[4], np.array([points[2], points[3]]), np.array([5., 6.]))
+    roadmap.preprocess_landmarks(2)
+
+    restored = pickle.loads(pickle.dumps(roadmap))
+
+    assert np.all(restored.states == roadmap.states)
+    assert np.all(restored.landmarks == roadmap.landmarks)
+    assert np.all(restored.landmark_distances == roadmap.landmark_distances)
+
+    for state in roadmap.states:
+        node = roadmap.node_at(state)
+        restored_node = restored.node_at(state)
+
+        order = np.lexsort(node.neighbors.T)
+        restored_order = np.lexsort(restored_node.neighbors.T)
+        assert np.all(node.neighbors[order] == restored_node.neighbors[restored_order])
+        assert np.all(node.costs[order] == restored_node.costs[restored_order])
+
+
+def test_edge_validity():
+    points = generate_test_points(n=3)
+
+    roadmap = Roadmap(2)
+    roadmap.add_node(points[0], np.array([]), np.array([]))
+    roadmap.add_node(points[1], np.array([points[0]]), np.array([1.]), EdgeValidity.unknown)
+    roadmap.add_node(points[2], np.array([points[0], points[1]]), np.array([5., 1.]), EdgeValidity.unknown)
+
+    assert roadmap.edge_validity(points[1], points[0]) == EdgeValidity.unknown
+    assert np.all(dijkstra(roadmap, points[0], points[2]) == points[[0, 1, 2]])
+
+    # Invalid edges are kept with their costs, but no search takes them
+    roadmap.set_edge_validity(points[0], points[1], EdgeValidity.invalid)
+    assert roadmap.edge_validity(points[1], points[0]) == EdgeValidity.invalid
+    assert roadmap.node_at(points[1]).costs[0] == 1.
+    assert np.all(dijkstra(roadmap, points[0], points[2]) == points[[0, 2]])
+    assert np.all(alt_search(roadmap, points[0], points[2]) == points[[0, 2]])
+
+    # Marking an edge valid again puts it back in the searches
+    roadmap.set_edge_validity(points[1], points[0], EdgeValidity.valid)
+    assert np.all(dijkstra(roadmap, points[0], points[2]) == points[[0, 1, 2]])
+    assert np.all(alt_search(roadmap, points[0], points[2]) == points[[0, 1, 2]])
+
+    roadmap.set_edge_validity(points[0], points[1], EdgeValidity.invalid)
+
+    restored = pickle.loads(pickle.dumps(roadmap))
+    assert restored.edge_validity(points[0], points[1]) == EdgeValidity.invalid
+    assert restored.edge_validity(points[0], points[2]) == EdgeValidity.unknown
+
+    try:
+        roadmap.edge_validity(points[0], points[0])
+        assert False, "Failed to catch MissingEdgeRoadmapException"
+
+    except MissingEdgeRoadmapException:
+        pass
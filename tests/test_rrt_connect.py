@@ -0,0 +1,39 @@
+import numpy as np
+import pytest
+from navitools import BadParameterException, SearchStatistics, rrt_connect
+from navitools.testing import make_wall_with_gap
+
+
+def test_rrt_connect(step_size: float = 0.5):
+    search_space = make_wall_with_gap(2.)
+    start, goal = np.array([-8., 0.]), np.array([8., 3.])
+
+    for seed in range(10):
+        statistics = SearchStatistics()
+        path = rrt_connect(search_space, start, goal, step_size, 0.05, 10000, 0., seed, statistics)
+
+        assert np.all(path[0] == start)
+        assert np.all(path[-1] == goal)
+
+        for a, b in zip(path[:-1], path[1:]):
+            assert search_space.valid_transition(a, b)
+            assert np.linalg.norm(b - a) <= step_size + 1e-9
+
+        assert statistics.n_expansions >= len(path) - 2
+        assert statistics.n_edge_checks >= statistics.n_expansions
+
+    # The same seed grows the same trees
+    assert np.all(rrt_connect(search_space, start, goal, step_size, seed=1) == rrt_connect(search_space, start, goal, step_size, seed=1))
+
+
+def test_rrt_connect_limits():
+    search_space = make_wall_with_gap(0.)
+    start, goal = np.array([-8., 0.]), np.array([8., 3.])
+
+    assert not rrt_connect(search_space, start, goal, 0.5, max_iterations=1000, seed=0).size
+    assert not rrt_connect(search_space, start, goal, 0.5, max_iterations=10 ** 9, max_seconds=0.05, seed=0).size
+
+    with pytest.raises(BadParameterException):
+        rrt_connect(search_space, start, goal, 0.)
+    with pytest.raises(BadParameterException):
+        rrt_connect(search_space, start, goal, 0.5, goal_bias=1.5)
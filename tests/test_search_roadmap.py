@@ -2,7 +2,9 @@ from random import choices
 from typing import Tuple
 
 import numpy as np
-from navitools import PolygonSpace, build_prm, dijkstra
+from navitools import EdgeValidity, PolygonSpace, SearchStatistics, alt_search, build_prm, delta_stepping, dijkstra, \
+    dijkstra_costs, lazy_search
+from navitools.testing import make_random_triangles, path_cost
 
 
 def test_dijkstra(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
@@ -16,3 +18,66 @@ def test_dijkstra(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float,
     assert path.size
     assert np.all(path[0] == start)
     assert np.all(path[-1] == goal)
+
+
+def test_alt_search(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace(make_random_triangles(20, xrange, yrange), xrange, yrange)
+
+    roadmap = build_prm(500, 10, 10, search_space)
+    roadmap.preprocess_landmarks(4)
+
+    assert roadmap.n_landmarks == 4
+    assert roadmap.landmark_distances.shape == (4, roadmap.n_states)
+
+    for _ in range(20):
+        start, goal = choices(roadmap.states, k=2)
+
+        dijkstra_statistics = SearchStatistics()
+        alt_statistics = SearchStatistics()
+
+        dijkstra_path = dijkstra(roadmap, start, goal, dijkstra_statistics)
+        alt_path = alt_search(roadmap, start, goal, alt_statistics)
+
+        assert dijkstra_path.size == 0 and alt_path.size == 0 or \
+            np.isclose(path_cost(roadmap, dijkstra_path), path_cost(roadmap, alt_path))
+        assert alt_statistics.n_expansions <= dijkstra_statistics.n_expansions
+
+
+def test_delta_stepping(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace(make_random_triangles(20, xrange, yrange), xrange, yrange)
+
+    roadmap = build_prm(1000, 10, 10, search_space)
+    source = choices(roadmap.states, k=1)[0]
+
+    expected = dijkstra_costs(roadmap, source)
+    assert expected.shape == (roadmap.n_states,)
+
+    for n_threads in (1, 2, 4):
+        assert np.array_equal(delta_stepping(roadmap, source, n_threads), expected)
+
+    assert np.array_equal(delta_stepping(roadmap, source, n_threads=2, delta=0.05), expected)
+
+    # Far more buckets than nodes
+    assert np.array_equal(delta_stepping(roadmap, source, n_threads=2, delta=1e-9), expected)
+
+
+def test_lazy_search(xrange: Tuple[float, float] = (-10, 10), yrange: Tuple[float, float] = (-10, 10)):
+    search_space = PolygonSpace(make_random_triangles(20, xrange, yrange), xrange, yrange)
+
+    roadmap = build_prm(1000, 10, 10, search_space, lazy=True)
+
+    assert all(validity == EdgeValidity.unknown for node in roadmap.nodes for validity in node.validity)
+
+    for _ in range(20):
+        start, goal = choices(roadmap.states, k=2)
+
+        statistics = SearchStatistics()
+        path = lazy_search(roadmap, search_space, start, goal, statistics)
+
+        for a, b in zip(path[:-1], path[1:]):
+            assert roadmap.edge_validity(a, b) == EdgeValidity.valid
+            assert search_space.valid_transition(a, b)
+
+        # The checks are cached, so the same search again checks nothing
+        lazy_search(roadmap, search_space, start, goal, statistics)
+        assert statistics.n_edge_checks == 0
@@ -1,5 +1,9 @@
 import numpy as np
-from navitools import Polygon, PolygonSpace, inside_polygon
+import pytest
+from navitools import BadBoxException, BadFootprintException, BadMeshException, BoxSpace, GridSpace, HaltonSequence, MeshSpace, \
+    NoFreeSpaceException, Polygon, PolygonSpace, RandomStream, SamplingMode, SE2PolygonSpace, SearchSpace, TriangleMesh, build_prm, \
+    inside_polygon, philox4x32_10, segment_intersects_polygon, wrap_angle
+from navitools.testing import make_random_triangles
 
 
 def test_search_space_instantiation():
@@ -19,3 +23,348 @@ def test_search_space_sample_free_sapce(n: int = 100_000):
     for sample in samples:
         assert not inside_polygon(sample, square)
         assert not inside_polygon(sample, triangle)
+
+
+def test_polygon_space_index(n_queries: int = 2_000):
+    # A clockwise polygon is hollow, and everything outside it is an obstacle
+    boundary = Polygon(np.array([[-9., 9.], [9., 9.], [9., -9.], [-9., -9.]]))
+    polygons = make_random_triangles(300, (-10, 10), (-10, 10)) + [boundary]
+
+    space = PolygonSpace(polygons, (-10, 10), (-10, 10))
+
+    stream = RandomStream(0)
+    starts = 20 * stream.uniform_block(n_queries, 2) - 10
+    ends = starts + 6 * (stream.uniform_block(n_queries, 2) - 0.5)
+
+    # Axis aligned segments and segments from polygon vertices are the easiest for the grid to get wrong
+    ends[::5, 0] = starts[::5, 0]
+    ends[1::5, 1] = starts[1::5, 1]
+    starts[2::5] = [polygons[i % len(polygons)][0] for i in range(len(starts[2::5]))]
+
+    for start, end in zip(starts, ends):
+        expected_state = not any(inside_polygon(start, polygon) for polygon in polygons)
+        assert space.valid_state(start) == expected_state
+
+        expected_transition = not any(segment_intersects_polygon((start, end), polygon) for polygon in polygons)
+        assert space.valid_transition(start, end) == expected_transition
+
+
+def test_free_space_raster(n: int = 20_000):
+    # Obstacle covering the left half of the map, with a diagonal edge through the middle cells
+    wedge = Polygon(np.array([[0., 0.], [2., 0.], [3., 5.], [0., 5.]]))
+    space = PolygonSpace([wedge], (0, 5), (0, 5))
+
+    space.set_free_space_raster(10)
+    raster = space.free_space_raster
+    assert raster.n_free_cells + raster.n_mixed_cells + raster.n_blocked_cells == 100
+    assert raster.n_mixed_cells and raster.n_blocked_cells
+
+    samples = space.sample_free_space(n, RandomStream(0))
+    assert all(space.valid_state(sample) for sample in samples)
+
+    # Uniform over the free space, whose area is 12.5, including the cells the edge crosses
+    free_area = 25. - 12.5
+    for x in (2.5, 3., 4.):
+        expected = (5 - x) * 5 / free_area if x >= 3 else 1 - 2.5 * (x - 2) ** 2 / free_area
+        assert abs(np.mean(samples[:, 0] >= x) - expected) < 0.02
+
+    # No free space at all
+    cover = Polygon(np.array([[-1., -1.], [6., -1.], [6., 6.], [-1., 6.]]))
+    with pytest.raises(NoFreeSpaceException):
+        PolygonSpace([cover], (0, 5), (0, 5)).set_free_space_raster(10)
+
+
+def test_grid_space(n: int = 5_000):
+    occupancy = RandomStream(0).uniform_block(30, 40) < 0.1
+    space = GridSpace(occupancy, 0.5, origin=(-5., 2.), seed=0)
+    assert space.n_free_cells == np.count_nonzero(~occupancy)
+
+    # Distance field against brute force, with a border of occupied cells around the grid
+    rows, cols = np.nonzero(np.pad(occupancy, 1, constant_values=True))
+    cells = np.stack(np.meshgrid(np.arange(1, 31), np.arange(1, 41), indexing='ij'), axis=-1)
+    expected = np.min(np.hypot(cells[..., :1] - rows, cells[..., 1:] - cols), axis=-1)
+    assert np.allclose(space.distance_field(), 0.5 * expected)
+
+    samples = space.sample_free_space(n, RandomStream(0))
+    assert all(space.valid_state(sample) for sample in samples)
+    assert not space.valid_state([-5.1, 3.]) and not space.valid_state([0., 17.1])
+
+    # The same map built from a square polygon per occupied cell, and a boundary around it
+    squares = [Polygon(np.array([[j, i], [j + 1, i], [j + 1, i + 1], [j, i + 1]]) * 0.5 + [-5., 2.])
+               for i, j in zip(*np.nonzero(occupancy))]
+    boundary = Polygon(np.array([[-5., 17.], [15., 17.], [15., 2.], [-5., 2.]]))
+    polygon_space = PolygonSpace(squares + [boundary], (-5, 15), (2, 17))
+
+    ends = samples + 4 * (RandomStream(1).uniform_block(n, 2) - 0.5)
+    ends[::5, 0] = samples[::5, 0]
+    ends[1::5, 1] = samples[1::5, 1]
+    for start, end in zip(samples, ends):
+        assert space.valid_transition(start, end) == polygon_space.valid_transition(start, end)
+
+
+def make_box(lower: np.ndarray, upper: np.ndarray) -> TriangleMesh:
+    vertices = np.array([[x, y, z] for x in (lower[0], upper[0]) for y in (lower[1], upper[1]) for z in (lower[2], upper[2])])
+    faces = np.array([[0, 1, 3], [0, 3, 2], [4, 6, 7], [4, 7, 5], [0, 4, 5], [0, 5, 1],
+                      [2, 3, 7], [2, 7, 6], [0, 2, 6], [0, 6, 4], [1, 5, 7], [1, 7, 3]])
+    return TriangleMesh(vertices, faces)
+
+
+def make_octahedron(center: np.ndarray, radius: float) -> TriangleMesh:
+    vertices = center + radius * np.array([[1., 0., 0.], [-1., 0., 0.], [0., 1., 0.], [0., -1., 0.], [0., 0., 1.], [0., 0., -1.]])
+    faces = np.array([[0, 2, 4], [2, 1, 4], [1, 3, 4], [3, 0, 4], [2, 0, 5], [1, 2, 5], [3, 1, 5], [0, 3, 5]])
+    return TriangleMesh(vertices, faces)
+
+
+def segment_hits_box(a: np.ndarray, b: np.ndarray, lower: np.ndarray, upper: np.ndarray) -> bool:
+    # Slab test, with the segment as t in [0, 1], against one box or against every row of lower and upper
+    direction = b - a
+    with np.errstate(divide='ignore', invalid='ignore'):
+        t_lower, t_upper = (lower - a) / direction, (upper - a) / direction
+    t_near = np.where(direction == 0, np.where((lower <= a) & (a <= upper), -np.inf, np.inf), np.minimum(t_lower, t_upper))
+    t_far = np.where(direction == 0, np.where((lower <= a) & (a <= upper), np.inf, -np.inf), np.maximum(t_lower, t_upper))
+    return np.maximum(t_near.max(axis=-1), 0.) <= np.minimum(t_far.min(axis=-1), 1.)
+
+
+def test_mesh_space(n: int = 2_000):
+    box_lower, box_upper = np.array([1., 1., 1.]), np.array([3., 4., 2.])
+    center, radius = np.array([6., 6., 6.]), 1.5
+    space = MeshSpace([make_box(box_lower, box_upper), make_octahedron(center, radius)], (0, 10), (0, 10), (0, 10), seed=0)
+
+    def in_obstacle(state: np.ndarray) -> bool:
+        return bool(np.all((box_lower <= state) & (state <= box_upper))) or np.abs(state - center).sum() <= radius
+
+    states = RandomStream(0).uniform_block(n, 3) * 10
+    for state in states:
+        if np.abs(np.abs(state - center).sum() - radius) > 1e-9:
+            assert space.valid_state(state) == (not in_obstacle(state))
+    assert not space.valid_state([2., 2., 1.]) and not space.valid_state([6., 6., 7.5])
+    assert not space.valid_state([-1., 5., 5.])
+    assert not space.valid_state([np.nan, 5., 5.])
+
+    samples = space.sample_free_space(n, RandomStream(1))
+    assert samples.shape == (n, 3)
+    assert not any(in_obstacle(sample) for sample in samples)
+
+    # Only the box's transitions have a simple exact reference
+    box_space = MeshSpace([make_box(box_lower, box_upper)], (0, 10), (0, 10), (0, 10))
+    free = box_space.sample_free_space(n, RandomStream(2))
+    ends = box_space.sample_free_space(n, RandomStream(3))
+    ends[::4, 0] = free[::4, 0]
+    for start, end in zip(free, ends):
+        assert box_space.valid_transition(start, end) == (not segment_hits_box(start, end, box_lower, box_upper))
+
+    # Transitions that lie in the plane of a face still touch the box
+    assert not box_space.valid_transition([0., 2., 2.], [5., 2., 2.])
+    assert not box_space.valid_transition([3., 0., 1.5], [3., 5., 1.5])
+
+    roadmap = build_prm(500, 10, 10, space, seed=0)
+    assert roadmap.states.shape[1] == 3
+
+    with pytest.raises(BadMeshException):
+        TriangleMesh(np.zeros((3, 3)), np.array([[0, 1, 3]]))
+
+
+def test_box_space(dimension: int = 4, n: int = 2_000):
+    # Few boxes are all tested for every query, and many go through the grid index
+    for n_boxes in (20, 500):
+        stream = RandomStream(n_boxes)
+        box_lower = 10 * stream.uniform_block(n_boxes, dimension)
+        box_upper = box_lower + 2 * stream.uniform_block(n_boxes, dimension)
+        lower, upper = np.zeros(dimension), np.full(dimension, 12.)
+
+        space = BoxSpace(box_lower, box_upper, lower, upper, seed=0)
+        assert space.n_boxes == n_boxes
+
+        def in_obstacle(state: np.ndarray) -> bool:
+            return bool(np.any(np.all((box_lower <= state) & (state <= box_upper), axis=1)))
+
+        for state in 12 * stream.uniform_block(n, dimension):
+            assert space.valid_state(state) == (not in_obstacle(state))
+        assert not space.valid_state(box_lower[0]) and not space.valid_state(np.full(dimension, -1.))
+
+        samples = space.sample_free_space(n, RandomStream(1))
+        assert not any(in_obstacle(sample) for sample in samples)
+
+        # Short transitions between free states, a third of them along the first axis only
+        ends = np.clip(samples + 2 * (stream.uniform_block(n, dimension) - 0.5), 0., 12.)
+        ends[::3, 1:] = samples[::3, 1:]
+        for start, end in zip(samples, ends):
+            touches = np.any(segment_hits_box(start, end, box_lower, box_upper))
+            assert space.valid_transition(start, end) == (not touches)
+
+        # A transition that only runs along a box's face still touches it
+        start, end = box_lower[0].copy(), box_lower[0].copy()
+        start[0], end[0] = 0., 12.
+        assert not space.valid_transition(start, end)
+
+        roadmap = build_prm(300, 10, 10, space, seed=0)
+        assert roadmap.states.shape[1] == dimension
+
+    with pytest.raises(BadBoxException):
+        BoxSpace(box_upper, box_lower, lower, upper)
+
+
+def test_se2_polygon_space(n: int = 200):
+    footprint = Polygon(np.array([[-1., -0.5], [1., -0.5], [1., 0.5], [-1., 0.5]]))
+    square = Polygon(np.array([[6.6, 4.], [7.6, 4.], [7.6, 6.], [6.6, 6.]]))
+    boundary = Polygon(np.array([[0., 10.], [10., 10.], [10., 0.], [0., 0.]]))
+    space = SE2PolygonSpace(footprint, [square, boundary], (0, 10), (0, 10), rotation_weight=2., seed=0)
+
+    # Headings wrap around, and transitions turn the short way
+    assert np.isclose(wrap_angle(3 * np.pi / 2), -np.pi / 2)
+    assert np.isclose(abs(space.interpolate(np.array([0., 0., 3.]), np.array([0., 0., -3.]), 0.5)[2]), np.pi)
+    assert np.isclose(space.transition_cost(np.array([0., 0., 3.]), np.array([3., 4., -3.])), 25 + (2 * (2 * np.pi - 6)) ** 2)
+
+    # The footprint's corner reaches furthest at a heading of atan(1 / 2), far enough to touch the square
+    assert space.valid_state([5.5, 5., 0.]) and space.valid_state([5.5, 5., 0.8])
+    assert not space.valid_state([5.5, 5., np.arctan(0.5)]) and not space.valid_state([0.8, 5., 0.])
+    assert np.allclose(space.footprint_at([5.5, 5., np.pi / 2]), [[6., 4.], [6., 6.], [5., 6.], [5., 4.]])
+
+    # Turning in place sweeps the corner through the square, while sliding past it does not
+    assert not space.valid_transition([5.5, 5., 0.], [5.5, 5., 0.8])
+    assert space.valid_transition([5.5, 2., 0.], [5.5, 8., 0.])
+    assert space.clearance([5.5, 5., 0.], 10.) == pytest.approx(0.1)
+
+    # Transitions passed as valid keep the footprint clear of the obstacles at every pose along them
+    stream = RandomStream(1)
+    starts = space.sample_free_space(n, stream)
+    ends = space.sample_free_space(n, stream)
+    for start, end in zip(starts, ends):
+        if space.valid_transition(start, end):
+            assert all(space.valid_state(space.interpolate(start, end, t)) for t in np.linspace(0, 1, 200))
+
+    roadmap = build_prm(300, 10, 10, space, seed=0)
+    assert roadmap.states.shape[1] == 3
+
+    with pytest.raises(BadFootprintException):
+        SE2PolygonSpace(Polygon(footprint.points[::-1]), [square], (0, 10), (0, 10))
+
+
+def test_random_stream():
+    block = RandomStream(seed=1).uniform_block(100, 3)
+
+    assert block.shape == (100, 3)
+    assert np.all((block >= 0) & (block < 1))
+
+    # The same seed and stream give the same numbers, whether drawn in blocks or one at a time
+    stream = RandomStream(seed=1)
+    assert all(stream.uniform() == value for value in block.flatten())
+
+    # Substreams are independent of each other and of their parent
+    parent = RandomStream(seed=1)
+    assert np.all(parent.substream(0).uniform_block(10, 3) == parent.substream(0).uniform_block(10, 3))
+    assert np.any(parent.substream(0).uniform_block(10, 3) != parent.substream(1).uniform_block(10, 3))
+    assert np.any(parent.substream(0).uniform_block(10, 3) != block[:10])
+
+
+def test_philox_known_answers():
+    # Known-answer vectors of Random123's Philox4x32-10
+    assert philox4x32_10([0, 0, 0, 0], [0, 0]) == [0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8]
+    assert philox4x32_10([0xffffffff] * 4, [0xffffffff] * 2) == [0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd]
+    assert philox4x32_10([0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344], [0xa4093822, 0x299f31d0]) == \
+        [0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1]
+
+    # The first block of seed 0, stream 0 gives the first two uniforms, 53 bits from each pair of words
+    stream = RandomStream(seed=0)
+    assert stream.uniform() == ((0x6627e8d5 >> 5) * 2 ** 26 + (0xe169c58d >> 6)) / 2 ** 53
+    assert stream.uniform() == ((0xbc57ac4c >> 5) * 2 ** 26 + (0x9b00dbd8 >> 6)) / 2 ** 53
+
+
+def test_search_space_seed():
+    square = Polygon(np.array([[0., 0.], [1., 0.], [1., 1.], [0., 1.]]))
+
+    a = PolygonSpace([square], (0, 5), (0, 5), seed=3)
+    b = PolygonSpace([square], (0, 5), (0, 5), seed=3)
+    assert np.all(a.sample_free_space(100) == b.sample_free_space(100))
+
+    samples = a.sample_free_space(100, RandomStream(seed=5))
+    assert np.all(samples == b.sample_free_space(100, RandomStream(seed=5)))
+    for sample in samples:
+        assert not inside_polygon(sample, square)
+
+    # A seeded build does not depend on the number of threads
+    roadmap = build_prm(500, 10, 10, a, n_threads=1, seed=7)
+    assert np.all(roadmap.states == build_prm(500, 10, 10, b, n_threads=4, seed=7).states)
+
+
+def test_halton_sampling(n: int = 1_000):
+    points = HaltonSequence(3, seed=1).next(n)
+
+    assert points.shape == (n, 3)
+    assert np.all((points >= 0) & (points < 1))
+
+    # Every one of the 10 x 10 cells gets close to its share of the points, which independent
+    # uniform samples are very unlikely to do
+    counts = np.histogram2d(points[:, 0], points[:, 1], bins=10, range=[(0, 1), (0, 1)])[0]
+    assert counts.min() >= 5 and counts.max() <= 15
+
+    square = Polygon(np.array([[0., 0.], [1., 0.], [1., 1.], [0., 1.]]))
+    space = PolygonSpace([square], (0, 5), (0, 5))
+    space.set_sampling_mode(SamplingMode.halton, seed=2)
+
+    assert space.sampling_mode == SamplingMode.halton
+    for sample in space.sample_free_space(n):
+        assert not inside_polygon(sample, square)
+
+    # Draws carry on along the sequence, whatever their stream, and setting the mode again restarts it
+    space.set_sampling_mode(SamplingMode.halton, seed=2)
+    first = space.sample_free_space(n, RandomStream(3))
+    assert not np.any(np.all(first == space.sample_free_space(n, RandomStream(3)), axis=1))
+
+    space.set_sampling_mode(SamplingMode.halton, seed=2)
+    assert np.all(space.sample_free_space(n) == first)
+
+    space.set_sampling_mode(SamplingMode.halton, seed=2)
+    roadmap = build_prm(300, 10, 10, space, seed=4)
+    space.set_sampling_mode(SamplingMode.halton, seed=2)
+    assert np.all(roadmap.states == build_prm(300, 10, 10, space, seed=4).states)
+
+
+class BatchSearchSpace(SearchSpace):
+
+    def __init__(self):
+        super().__init__(2)
+        self.n_batch_calls = 0
+
+    def sample_free_space(self, n: int):
+        return np.random.uniform(0, 1, (n, 2))
+
+    def valid_transition(self, a: np.ndarray, b: np.ndarray) -> bool:
+        raise AssertionError('build_prm should use the batch form')
+
+    def transition_cost(self, a: np.ndarray, b: np.ndarray) -> float:
+        raise AssertionError('build_prm should use the batch form')
+
+    def valid_transitions(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+        self.n_batch_calls += 1
+        return a[:, 0] < 0.5
+
+    def transition_costs(self, a: np.ndarray, b: np.ndarray) -> np.ndarray:
+        return np.linalg.norm(a - b, axis=1)
+
+
+def test_search_space_batch_defaults():
+    square = Polygon(np.array([[0., 0.], [1., 0.], [1., 1.], [0., 1.]]))
+    space = PolygonSpace([square], (0, 5), (0, 5))
+
+    a = np.random.uniform(0, 5, (100, 2))
+    b = np.random.uniform(0, 5, (100, 2))
+
+    valid = space.valid_transitions(a, b)
+    costs = space.transition_costs(a, b)
+
+    assert valid.dtype == bool
+    for i in range(len(a)):
+        assert valid[i] == space.valid_transition(a[i], b[i])
+        assert costs[i] == space.transition_cost(a[i], b[i])
+
+
+def test_build_prm_batch_search_space():
+    space = BatchSearchSpace()
+    roadmap = build_prm(200, 10, 5, space)
+
+    assert space.n_batch_calls > 0
+    # Every edge was checked from a sample that the batch form accepted
+    for node in roadmap.nodes:
+        for neighbor in node.neighbors:
+            assert node.state[0] < 0.5 or neighbor[0] < 0.5